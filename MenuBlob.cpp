@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include "MenuBlob.h"
+#include <string.h>
+#if defined(__AVR__)
+  #include <new.h>
+#else
+  #include <new>
+#endif
+
+namespace {
+
+uint16_t get_uint16(uint8_t const* p) {
+    return p[0] | ((uint16_t) p[1] << 8);
+}
+
+uint32_t get_uint32(uint8_t const* p) {
+    return get_uint16(p) | ((uint32_t) get_uint16(p + 2) << 16);
+}
+
+size_t get_padded_size(size_t size, size_t alignment) {
+    return size + alignment - 1;
+}
+
+}
+
+MenuBlobLoader::MenuBlobLoader(MenuSystem& menu_system, uint8_t* arena,
+                               size_t arena_size)
+: _menu_system(menu_system),
+  _arena(arena),
+  _arena_size(arena_size),
+  _arena_used(0),
+  _arena_end(arena_size),
+  _menus(nullptr),
+  _num_menus(0),
+  _max_menus(0),
+  _select_fns(nullptr),
+  _num_select_fns(0),
+  _error(ERROR_NONE),
+  _p_blob(nullptr),
+  _p_blob_end(nullptr),
+  _p_in(nullptr) {
+}
+
+void MenuBlobLoader::set_select_functions(
+        MenuComponent::SelectFnPtr const* select_fns, uint8_t num_select_fns) {
+    _select_fns = select_fns;
+    _num_select_fns = num_select_fns;
+}
+
+bool MenuBlobLoader::load(Menu& menu, uint8_t const* blob, size_t blob_size) {
+    _p_blob = blob;
+    _p_blob_end = blob + blob_size;
+    _p_in = nullptr;
+    return load(menu);
+}
+
+bool MenuBlobLoader::load(Menu& menu, Stream& in) {
+    _p_blob = nullptr;
+    _p_blob_end = nullptr;
+    _p_in = &in;
+    return load(menu);
+}
+
+MenuBlobLoader::Error MenuBlobLoader::get_error() const {
+    return _error;
+}
+
+size_t MenuBlobLoader::get_arena_used() const {
+    return _arena_used;
+}
+
+size_t MenuBlobLoader::get_arena_size(uint8_t const* header, bool copy_names) {
+    if (get_uint16(header) != MenuBlob::MAGIC
+            || header[2] != MenuBlob::VERSION)
+        return 0;
+
+    size_t size = get_uint16(header + 4)
+                  * get_padded_size(sizeof(Node), alignof(Node));
+    size += get_uint16(header + 6)
+            * (get_padded_size(sizeof(Menu), alignof(Menu)) + sizeof(Menu*));
+    size += get_uint16(header + 8)
+            * get_padded_size(sizeof(MenuItem), alignof(MenuItem));
+#if MENUSYSTEM_BACK_ITEM
+    size += get_uint16(header + 10)
+            * get_padded_size(sizeof(BackMenuItem), alignof(BackMenuItem));
+#endif
+#if MENUSYSTEM_NUMERIC
+    size += get_uint16(header + 12)
+            * get_padded_size(sizeof(NumericMenuItem), alignof(NumericMenuItem));
+#endif
+    if (copy_names)
+        size += get_uint32(header + 14);
+    return size;
+}
+
+bool MenuBlobLoader::load(Menu& menu) {
+    const Menu::ComponentIndex max_components =
+        (Menu::ComponentIndex) ~(Menu::ComponentIndex) 0;
+
+    _error = ERROR_NONE;
+
+    uint8_t header[MenuBlob::HEADER_SIZE];
+    if (!read(header, sizeof(header)))
+        return false;
+    if (get_arena_size(header, false) == 0)
+        return fail(ERROR_FORMAT);
+
+    uint16_t num_root_nodes = get_uint16(header + 4);
+    if (num_root_nodes > max_components - menu.get_num_components())
+        return fail(ERROR_UNSUPPORTED);
+
+    // The components of menu are collected at the end of the arena and only
+    // added once the whole tree is loaded, so a failed load leaves menu
+    // unchanged. The menus built are recorded below them so a failed load
+    // can free their component lists.
+    size_t arena_used = _arena_used;
+    uint16_t num_menus = get_uint16(header + 6);
+    size_t root_nodes_size = num_root_nodes * sizeof(Node);
+    size_t root_nodes_end = (size_t) (_arena + _arena_size) & ~(alignof(Node) - 1);
+    if (root_nodes_end < (size_t) (_arena + _arena_used) + root_nodes_size
+                         + num_menus * sizeof(Menu*))
+        return fail(ERROR_ARENA);
+    Node* root_nodes = (Node*) (root_nodes_end - root_nodes_size);
+    _menus = (Menu**) root_nodes - num_menus;
+    _num_menus = 0;
+    _max_menus = num_menus;
+    _arena_end = (uint8_t*) _menus - _arena;
+
+    Frame stack[MENUSYSTEM_MAX_DEPTH];
+    uint8_t depth = 0;
+    bool loaded = true;
+    for (uint16_t i = 0; loaded && i < num_root_nodes; ++i) {
+        Node node;
+        loaded = read_node(node);
+        root_nodes[i] = node;
+
+        while (loaded) {
+            if (node.p_menu != nullptr && node.num_components > 0) {
+                if (depth == MENUSYSTEM_MAX_DEPTH) {
+                    loaded = fail(ERROR_UNSUPPORTED);
+                    break;
+                }
+                stack[depth].p_menu = node.p_menu;
+                stack[depth].num_remaining = node.num_components;
+                ++depth;
+            }
+
+            while (depth > 0 && stack[depth - 1].num_remaining == 0)
+                --depth;
+            if (depth == 0)
+                break;
+
+            Frame& frame = stack[depth - 1];
+            --frame.num_remaining;
+            loaded = read_node(node);
+            if (loaded)
+                attach(*frame.p_menu, node);
+        }
+    }
+
+    if (loaded && !menu.reserve(menu.get_num_components() + num_root_nodes))
+        loaded = fail(ERROR_MEMORY);
+    if (!loaded) {
+        unload(arena_used);
+        return false;
+    }
+
+    _arena_end = _arena_size;
+    for (uint16_t i = 0; i < num_root_nodes; ++i)
+        attach(menu, root_nodes[i]);
+    return true;
+}
+
+bool MenuBlobLoader::read(void* p_data, size_t length) {
+    if (_p_in != nullptr) {
+        if (_p_in->readBytes((uint8_t*) p_data, length) != length)
+            return fail(ERROR_TRUNCATED);
+        return true;
+    }
+
+    if ((size_t) (_p_blob_end - _p_blob) < length)
+        return fail(ERROR_TRUNCATED);
+    memcpy(p_data, _p_blob, length);
+    _p_blob += length;
+    return true;
+}
+
+const char* MenuBlobLoader::read_name() {
+    if (_p_in == nullptr) {
+        uint8_t const* p_end = (uint8_t const*) memchr(_p_blob, '\0',
+                                                        _p_blob_end - _p_blob);
+        if (p_end == nullptr) {
+            fail(ERROR_TRUNCATED);
+            return nullptr;
+        }
+        const char* name = (const char*) _p_blob;
+        _p_blob = p_end + 1;
+        return name;
+    }
+
+    char* name = (char*) _arena + _arena_used;
+    char c;
+    do {
+        if (!read(&c, 1))
+            return nullptr;
+        char* p = (char*) allocate(1, 1);
+        if (p == nullptr)
+            return nullptr;
+        *p = c;
+    } while (c != '\0');
+    return name;
+}
+
+template <typename T, typename... Args>
+T* MenuBlobLoader::create(Args... args) {
+    void* p = allocate(sizeof(T), alignof(T));
+    if (p == nullptr)
+        return nullptr;
+    return new (p) T(args...);
+}
+
+bool MenuBlobLoader::read_node(Node& node) {
+    uint8_t fields[3];
+    if (!read(fields, sizeof(fields)))
+        return false;
+
+    MenuComponent::SelectFnPtr select_fn = nullptr;
+    if (fields[2] != MenuBlob::NO_SELECT_FN) {
+        if (fields[2] >= _num_select_fns)
+            return fail(ERROR_FORMAT);
+        select_fn = _select_fns[fields[2]];
+    }
+
+    node.p_item = nullptr;
+    node.p_menu = nullptr;
+    node.num_components = 0;
+    node.flags = fields[1];
+
+    switch (fields[0]) {
+        case MenuBlob::NODE_ITEM: {
+            const char* name = read_name();
+            if (name == nullptr)
+                return false;
+            node.p_item = create<MenuItem>(name, select_fn);
+            break;
+        }
+        case MenuBlob::NODE_BACK_ITEM: {
+#if MENUSYSTEM_BACK_ITEM
+            const char* name = read_name();
+            if (name == nullptr)
+                return false;
+            node.p_item = create<BackMenuItem>(name, select_fn, &_menu_system);
+            break;
+#else
+            return fail(ERROR_UNSUPPORTED);
+#endif
+        }
+        case MenuBlob::NODE_NUMERIC_ITEM: {
+#if MENUSYSTEM_NUMERIC
+            float values[4];
+            if (!read(values, sizeof(values)))
+                return false;
+            const char* name = read_name();
+            if (name == nullptr)
+                return false;
+            node.p_item = create<NumericMenuItem>(name, select_fn, values[0],
+                                                  values[1], values[2],
+                                                  values[3]);
+            break;
+#else
+            return fail(ERROR_UNSUPPORTED);
+#endif
+        }
+        case MenuBlob::NODE_MENU: {
+            uint8_t count[2];
+            if (!read(count, sizeof(count)))
+                return false;
+            const Menu::ComponentIndex max_components =
+                (Menu::ComponentIndex) ~(Menu::ComponentIndex) 0;
+            uint16_t num_components = get_uint16(count);
+            if (num_components > max_components)
+                return fail(ERROR_UNSUPPORTED);
+            const char* name = read_name();
+            if (name == nullptr)
+                return false;
+            if (_num_menus == _max_menus)
+                return fail(ERROR_FORMAT);
+            node.p_menu = create<Menu>(name, select_fn);
+            if (node.p_menu == nullptr)
+                return false;
+            _menus[_num_menus++] = node.p_menu;
+            if (!node.p_menu->reserve(num_components))
+                return fail(ERROR_MEMORY);
+            node.num_components = num_components;
+            return true;
+        }
+        default:
+            return fail(ERROR_FORMAT);
+    }
+
+    return node.p_item != nullptr;
+}
+
+void* MenuBlobLoader::allocate(size_t size, size_t alignment) {
+    size_t address = (size_t) (_arena + _arena_used);
+    size_t padding = (alignment - address % alignment) % alignment;
+    if (_arena_end - _arena_used < padding + size) {
+        fail(ERROR_ARENA);
+        return nullptr;
+    }
+
+    _arena_used += padding + size;
+    return (void*) (address + padding);
+}
+
+bool MenuBlobLoader::fail(Error error) {
+    _error = error;
+    return false;
+}
+
+void MenuBlobLoader::unload(size_t arena_used) {
+    for (uint16_t i = 0; i < _num_menus; ++i)
+        _menus[i]->release();
+    _arena_used = arena_used;
+    _arena_end = _arena_size;
+}
+
+void MenuBlobLoader::attach(Menu& menu, Node const& node) {
+    Menu::ComponentIndex index = menu.get_num_components();
+    if (node.p_menu != nullptr)
+        menu.add_menu(node.p_menu);
+    else
+        menu.add_item(node.p_item);
+
+    if (node.flags & MenuBlob::FLAG_HIDDEN)
+        menu.set_component_visible(index, false);
+    if (node.flags & MenuBlob::FLAG_DISABLED)
+        menu.set_component_enabled(index, false);
+}
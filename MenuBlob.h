@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#ifndef MENUBLOB_H
+#define MENUBLOB_H
+
+#include "MenuSystem.h"
+
+//! \brief Constants of the binary menu tree format
+//!
+//! A blob describes a menu tree so it can be kept in a file (e.g. on an SD
+//! card) instead of being built in code. `extras/menublob.py` compiles a text
+//! description into a blob. Multi-byte integers and floats (IEEE-754) are
+//! little-endian.
+//!
+//! The blob starts with a header:
+//!
+//!     offset  size  field
+//!          0     2  MAGIC
+//!          2     1  VERSION
+//!          3     1  reserved, 0
+//!          4     2  number of components of the root menu
+//!          6     2  number of menus
+//!          8     2  number of items
+//!         10     2  number of back items
+//!         12     2  number of numeric items
+//!         14     4  total length of the names, NUL terminators included
+//!
+//! The components follow in depth-first order: a menu's components follow
+//! it. Every component is:
+//!
+//!     uint8 NodeType
+//!     uint8 NodeFlags
+//!     uint8 select function id, NO_SELECT_FN for none
+//!     NODE_MENU:         uint16 number of components
+//!     NODE_NUMERIC_ITEM: float value, min, max and increment
+//!     the name, NUL terminated
+//!
+//! The select function id indexes the table given to
+//! MenuBlobLoader::set_select_functions.
+//!
+//! \see MenuBlobLoader
+class MenuBlob {
+public:
+    static const uint16_t MAGIC = 0x424D; // "MB"
+    static const uint8_t VERSION = 1;
+    static const uint8_t HEADER_SIZE = 18;
+    static const uint8_t NO_SELECT_FN = 0xFF;
+
+    //! Same values as MenuStream::NodeType; choice items aren't supported
+    //! because their labels must be stored in flash.
+    enum NodeType : uint8_t {
+        NODE_ITEM = 0,
+        NODE_BACK_ITEM = 1,
+        NODE_NUMERIC_ITEM = 2,
+        NODE_MENU = 4
+    };
+
+    //! Same values as MenuStream::NodeFlags.
+    enum NodeFlags : uint8_t {
+        FLAG_HIDDEN = 0x01,
+        FLAG_DISABLED = 0x02
+    };
+};
+
+
+//! \brief Builds a menu tree from a MenuBlob
+//!
+//! All components are constructed in an arena supplied by the client, so the
+//! loader itself allocates nothing; only the component lists of the menus
+//! come from the heap, each sized exactly with Menu::reserve. A failed load
+//! frees them again.
+//!
+//! A blob can be loaded in place from memory, e.g. a file mapped with mmap on
+//! the host or a blob in RAM: the names then point into the blob, which must
+//! outlive the menus. It can also be read from a Stream, e.g. an SD card
+//! File: the names are then copied into the arena.
+//!
+//! \code
+//! uint8_t arena[1024];
+//! MenuComponent::SelectFnPtr select_fns[] = { on_save, on_about };
+//! MenuBlobLoader loader(ms, arena, sizeof(arena));
+//!
+//! void setup() {
+//!     File file = SD.open("menu.bin");
+//!     loader.set_select_functions(select_fns, 2);
+//!     if (!loader.load(ms.get_root_menu(), file))
+//!         Serial.println(loader.get_error());
+//! }
+//! \endcode
+//!
+//! \see MenuBlob
+class MenuBlobLoader {
+public:
+    enum Error : uint8_t {
+        ERROR_NONE,
+        //! The blob is malformed, e.g. bad magic, version or node type.
+        ERROR_FORMAT,
+        //! The blob ended before the tree was complete.
+        ERROR_TRUNCATED,
+        //! The arena is too small for the tree.
+        ERROR_ARENA,
+        //! A menu's component list couldn't be allocated.
+        ERROR_MEMORY,
+        //! The blob uses a component type that was compiled out, nests
+        //! menus deeper than MENUSYSTEM_MAX_DEPTH or has a menu with more
+        //! components than Menu::ComponentIndex can index.
+        ERROR_UNSUPPORTED
+    };
+
+public:
+    //! \brief Construct a MenuBlobLoader
+    //!
+    //! \param[in] menu_system The menu system the back items act on.
+    //! \param[in] arena Storage for the components.
+    //! \param[in] arena_size The size of arena in bytes.
+    MenuBlobLoader(MenuSystem& menu_system, uint8_t* arena, size_t arena_size);
+
+    //! \brief Sets the select functions the blob refers to by id
+    //!
+    //! \param[in] select_fns The functions; the table must outlive the
+    //!                       loader.
+    //! \param[in] num_select_fns The number of elements in select_fns.
+    void set_select_functions(MenuComponent::SelectFnPtr const* select_fns,
+                              uint8_t num_select_fns);
+
+    //! \brief Loads a blob in place
+    //!
+    //! The components are added to menu. The names point into blob.
+    //!
+    //! \returns true on success. On failure menu is left unchanged and
+    //!          MenuBlobLoader::get_error tells why.
+    bool load(Menu& menu, uint8_t const* blob, size_t blob_size);
+
+    //! \brief Loads a blob from a stream
+    //!
+    //! \copydetails MenuBlobLoader::load(Menu&, uint8_t const*, size_t)
+    //! The names are copied into the arena.
+    bool load(Menu& menu, Stream& in);
+
+    //! \brief Returns why the last load failed
+    Error get_error() const;
+
+    //! \brief Returns the number of arena bytes in use
+    //!
+    //! Several blobs can be loaded into the same arena.
+    size_t get_arena_used() const;
+
+    //! \brief Returns an upper bound of the arena a blob needs
+    //!
+    //! \param[in] header The first MenuBlob::HEADER_SIZE bytes of the blob.
+    //! \param[in] copy_names true if the blob is loaded from a stream.
+    //! \returns The size in bytes, or 0 if the header is invalid.
+    static size_t get_arena_size(uint8_t const* header, bool copy_names);
+
+private:
+    struct Node {
+        MenuItem* p_item;
+        Menu* p_menu;
+        Menu::ComponentIndex num_components;
+        uint8_t flags;
+    };
+
+    struct Frame {
+        Menu* p_menu;
+        Menu::ComponentIndex num_remaining;
+    };
+
+private:
+    bool load(Menu& menu);
+    bool read(void* p_data, size_t length);
+    const char* read_name();
+    bool read_node(Node& node);
+    void* allocate(size_t size, size_t alignment);
+    bool fail(Error error);
+    void unload(size_t arena_used);
+
+    static void attach(Menu& menu, Node const& node);
+
+    template <typename T, typename... Args>
+    T* create(Args... args);
+
+private:
+    MenuSystem& _menu_system;
+    uint8_t* _arena;
+    size_t _arena_size;
+    size_t _arena_used;
+    size_t _arena_end;
+    Menu** _menus;
+    uint16_t _num_menus;
+    uint16_t _max_menus;
+    MenuComponent::SelectFnPtr const* _select_fns;
+    uint8_t _num_select_fns;
+    Error _error;
+    uint8_t const* _p_blob;
+    uint8_t const* _p_blob_end;
+    Stream* _p_in;
+};
+
+#endif
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include "MenuInput.h"
+
+MenuInput::MenuInput(MenuSystem& menu_system)
+: _menu_system(menu_system),
+  _debounce_time(20),
+  _long_press_time(800),
+  _double_press_time(300),
+  _repeat_delay(500),
+  _repeat_interval(100),
+  _loop(false) {
+    for (uint8_t i = 0; i < MENUINPUT_MAX_BUTTONS; ++i)
+        set_button(i, ACTION_NONE);
+}
+
+void MenuInput::set_button(uint8_t button, Action press_action,
+                           Action long_press_action,
+                           Action double_press_action, bool repeat) {
+    if (button >= MENUINPUT_MAX_BUTTONS)
+        return;
+
+    Button& b = _buttons[button];
+    b.press_action = press_action;
+    b.long_press_action = long_press_action;
+    b.double_press_action = double_press_action;
+    b.repeat = repeat;
+    b.raw = false;
+    b.pressed = false;
+    b.consumed = false;
+    b.waiting_double = false;
+    b.raw_changed_at = 0;
+    b.pressed_at = 0;
+    b.released_at = 0;
+    b.next_repeat_at = 0;
+}
+
+void MenuInput::set_debounce_time(uint16_t debounce_time) {
+    _debounce_time = debounce_time;
+}
+
+void MenuInput::set_long_press_time(uint16_t long_press_time) {
+    _long_press_time = long_press_time;
+}
+
+void MenuInput::set_double_press_time(uint16_t double_press_time) {
+    _double_press_time = double_press_time;
+}
+
+void MenuInput::set_repeat_time(uint16_t delay, uint16_t interval) {
+    _repeat_delay = delay;
+    _repeat_interval = interval;
+}
+
+void MenuInput::set_loop(bool loop) {
+    _loop = loop;
+}
+
+void MenuInput::sample(uint8_t button, bool pressed, uint32_t now) {
+    if (button >= MENUINPUT_MAX_BUTTONS)
+        return;
+
+    Button& b = _buttons[button];
+    if (pressed != b.raw) {
+        b.raw = pressed;
+        b.raw_changed_at = now;
+    }
+    process(b, now);
+}
+
+void MenuInput::update(uint32_t now) {
+    for (uint8_t i = 0; i < MENUINPUT_MAX_BUTTONS; ++i)
+        process(_buttons[i], now);
+}
+
+void MenuInput::dispatch(Action action) {
+    switch (action) {
+        case ACTION_NEXT:
+            _menu_system.next(_loop);
+            break;
+        case ACTION_PREV:
+            _menu_system.prev(_loop);
+            break;
+        case ACTION_SELECT:
+            _menu_system.select();
+            break;
+        case ACTION_BACK:
+            _menu_system.back();
+            break;
+        case ACTION_RESET:
+            _menu_system.reset();
+            break;
+        default:
+            break;
+    }
+}
+
+void MenuInput::process(Button& b, uint32_t now) {
+    // Accept the raw state once it has been stable for the debounce time
+    if (b.raw != b.pressed && now - b.raw_changed_at >= _debounce_time) {
+        b.pressed = b.raw;
+        if (b.pressed)
+            on_press(b, now);
+        else
+            on_release(b, now);
+    }
+
+    if (b.pressed) {
+        if (b.long_press_action != ACTION_NONE) {
+            if (!b.consumed && now - b.pressed_at >= _long_press_time) {
+                b.consumed = true;
+                dispatch(b.long_press_action);
+            }
+        } else if (b.repeat && b.double_press_action == ACTION_NONE
+                && (int32_t) (now - b.next_repeat_at) >= 0) {
+            // A stalled loop gets a single repeat rather than a burst
+            b.next_repeat_at = now + _repeat_interval;
+            dispatch(b.press_action);
+        }
+    } else if (b.waiting_double && now - b.released_at >= _double_press_time) {
+        b.waiting_double = false;
+        dispatch(b.press_action);
+    }
+}
+
+void MenuInput::on_press(Button& b, uint32_t now) {
+    b.pressed_at = now;
+    b.next_repeat_at = now + _repeat_delay;
+    b.consumed = false;
+
+    if (b.waiting_double) {
+        b.waiting_double = false;
+        b.consumed = true;
+        dispatch(b.double_press_action);
+    } else if (b.long_press_action == ACTION_NONE
+            && b.double_press_action == ACTION_NONE) {
+        dispatch(b.press_action);
+    }
+}
+
+void MenuInput::on_release(Button& b, uint32_t now) {
+    b.released_at = now;
+
+    if (b.consumed) {
+        b.consumed = false;
+        return;
+    }
+
+    // Buttons without gestures acted when pressed
+    if (b.long_press_action == ACTION_NONE
+            && b.double_press_action == ACTION_NONE)
+        return;
+
+    if (b.double_press_action != ACTION_NONE)
+        b.waiting_double = true;
+    else
+        dispatch(b.press_action);
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#ifndef MENUINPUT_H
+#define MENUINPUT_H
+
+#include "MenuSystem.h"
+
+//! \brief The maximum number of buttons a MenuInput can track
+//!
+//! Define it in the build flags to override the default.
+#ifndef MENUINPUT_MAX_BUTTONS
+  #define MENUINPUT_MAX_BUTTONS 4
+#endif
+
+//! \brief Turns raw button samples into MenuSystem actions
+//!
+//! MenuInput debounces timestamped button samples without blocking and
+//! recognises presses, long presses, double presses and auto-repeat, then
+//! calls the matching MenuSystem method. Every sample is processed in
+//! constant time and all state lives in a fixed array of buttons.
+//!
+//! Time is passed in by the caller, usually `millis()`, so the gestures can
+//! be driven by a synthetic timeline on the host.
+//!
+//! \code
+//! MenuInput input(ms);
+//!
+//! void setup() {
+//!     input.set_button(0, MenuInput::ACTION_NEXT, MenuInput::ACTION_NONE,
+//!                      MenuInput::ACTION_NONE, true);
+//!     input.set_button(1, MenuInput::ACTION_SELECT, MenuInput::ACTION_BACK);
+//! }
+//!
+//! void loop() {
+//!     uint32_t now = millis();
+//!     input.sample(0, digitalRead(PIN_DOWN) == LOW, now);
+//!     input.sample(1, digitalRead(PIN_OK) == LOW, now);
+//!     ms.display();
+//! }
+//! \endcode
+class MenuInput {
+public:
+    enum Action : uint8_t {
+        ACTION_NONE,
+        ACTION_NEXT,
+        ACTION_PREV,
+        ACTION_SELECT,
+        ACTION_BACK,
+        ACTION_RESET
+    };
+
+public:
+    //! \brief Construct a MenuInput
+    //! \param[in] menu_system The menu system actions are dispatched to.
+    MenuInput(MenuSystem& menu_system);
+
+    //! \brief Configures a button
+    //!
+    //! A button's press action fires as soon as it's pressed, unless the
+    //! button also has a long press or double press action: then it fires
+    //! when the button is released early, or when no second press follows
+    //! within the double press window.
+    //!
+    //! \param[in] button The button number, less than MENUINPUT_MAX_BUTTONS.
+    //! \param[in] press_action The action of a short press.
+    //! \param[in] long_press_action The action when the button is held for
+    //!                              the long press time.
+    //! \param[in] double_press_action The action of two presses within the
+    //!                                double press window.
+    //! \param[in] repeat if true the press action repeats while the button is
+    //!                   held; ignored when there's a long press or double
+    //!                   press action, since the press action then only
+    //!                   fires after the release.
+    void set_button(uint8_t button, Action press_action,
+                    Action long_press_action=ACTION_NONE,
+                    Action double_press_action=ACTION_NONE,
+                    bool repeat=false);
+
+    //! \brief Sets how long a raw state must be stable to be accepted
+    void set_debounce_time(uint16_t debounce_time);
+
+    //! \brief Sets how long a button must be held for a long press
+    void set_long_press_time(uint16_t long_press_time);
+
+    //! \brief Sets the maximum time between the presses of a double press
+    void set_double_press_time(uint16_t double_press_time);
+
+    //! \brief Sets the auto-repeat delay and interval
+    //! \param[in] delay The time a button is held before it repeats.
+    //! \param[in] interval The time between repeats.
+    void set_repeat_time(uint16_t delay, uint16_t interval);
+
+    //! \brief Sets whether next and prev loop around the menu
+    void set_loop(bool loop);
+
+    //! \brief Processes a raw sample of a button
+    //!
+    //! \param[in] button The button number.
+    //! \param[in] pressed The raw state of the button.
+    //! \param[in] now The time of the sample in milliseconds.
+    void sample(uint8_t button, bool pressed, uint32_t now);
+
+    //! \brief Advances the timers of all buttons
+    //!
+    //! Needed only when buttons aren't sampled regularly, e.g. when samples
+    //! come from pin change interrupts; MenuInput::sample does the same for
+    //! the sampled button.
+    //!
+    //! \param[in] now The current time in milliseconds.
+    void update(uint32_t now);
+
+    //! \brief Dispatches an action to the menu system
+    //!
+    //! Useful for inputs that need no gesture recognition, like rotary
+    //! encoder steps.
+    void dispatch(Action action);
+
+private:
+    struct Button {
+        Action press_action;
+        Action long_press_action;
+        Action double_press_action;
+        bool repeat;
+        bool raw;
+        bool pressed;
+        bool consumed;
+        bool waiting_double;
+        uint32_t raw_changed_at;
+        uint32_t pressed_at;
+        uint32_t released_at;
+        uint32_t next_repeat_at;
+    };
+
+private:
+    void process(Button& button, uint32_t now);
+    void on_press(Button& button, uint32_t now);
+    void on_release(Button& button, uint32_t now);
+
+private:
+    MenuSystem& _menu_system;
+    Button _buttons[MENUINPUT_MAX_BUTTONS];
+    uint16_t _debounce_time;
+    uint16_t _long_press_time;
+    uint16_t _double_press_time;
+    uint16_t _repeat_delay;
+    uint16_t _repeat_interval;
+    bool _loop;
+};
+
+#endif
@@ -0,0 +1,704 @@
+/*
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include "MenuStream.h"
+#include <string.h>
+
+namespace {
+
+Menu const* as_menu(MenuComponent const& component) {
+    if (component.get_type() != MenuComponent::TYPE_MENU)
+        return nullptr;
+    return static_cast<Menu const*>(&component);
+}
+
+#if MENUSYSTEM_NUMERIC
+NumericMenuItem const* as_numeric_item(MenuComponent const& component) {
+    if (component.get_type() != MenuComponent::TYPE_NUMERIC_MENU_ITEM)
+        return nullptr;
+    return static_cast<NumericMenuItem const*>(&component);
+}
+
+ChoiceMenuItem const* as_choice_item(MenuComponent const& component) {
+    if (component.get_type() != MenuComponent::TYPE_CHOICE_MENU_ITEM)
+        return nullptr;
+    return static_cast<ChoiceMenuItem const*>(&component);
+}
+#endif
+
+uint8_t get_flags(Menu const& menu, Menu::ComponentIndex index) {
+    uint8_t flags = 0;
+    if (!menu.is_component_visible(index))
+        flags |= MenuStream::FLAG_HIDDEN;
+    if (!menu.is_component_enabled(index))
+        flags |= MenuStream::FLAG_DISABLED;
+    return flags;
+}
+
+uint8_t clamp_length(size_t length, uint8_t max_length) {
+    return length < max_length ? length : max_length;
+}
+
+}
+
+// *********************************************************
+// MenuStreamWriter
+// *********************************************************
+
+MenuStreamWriter::MenuStreamWriter(MenuSystem const& menu_system, Print& out)
+: _menu_system(menu_system),
+  _out(out),
+  _sequence(0),
+  _checksum(0),
+#if MENUSYSTEM_INSTRUMENTATION
+  _generation(menu_system.get_generation()),
+#endif
+  _p_menu(nullptr),
+  _depth(0),
+  _path(),
+  _flags_generation(0),
+  _snapshot_flags_generation(0),
+  _flags_stale(false),
+  _cursor(0),
+  _has_focus(false)
+#if MENUSYSTEM_NUMERIC
+  , _value(0),
+  _choice(0)
+#endif
+{
+}
+
+void MenuStreamWriter::send_snapshot() {
+    begin_frame(MenuStream::MSG_SNAPSHOT_BEGIN, 0);
+    end_frame();
+
+    send_node(_menu_system.get_root_menu(), 0);
+
+    begin_frame(MenuStream::MSG_SNAPSHOT_END, 0);
+    end_frame();
+
+    send_state(true);
+}
+
+void MenuStreamWriter::update() {
+#if MENUSYSTEM_INSTRUMENTATION
+    if (_generation == _menu_system.get_generation())
+        return;
+#endif
+
+    send_state(false);
+}
+
+void MenuStreamWriter::send_node(MenuComponent const& component,
+                                 uint8_t flags) {
+    Menu const* p_menu = as_menu(component);
+#if MENUSYSTEM_NUMERIC
+    NumericMenuItem const* p_numeric_item = as_numeric_item(component);
+    ChoiceMenuItem const* p_choice_item = as_choice_item(component);
+#endif
+
+    uint8_t header_length = 2;
+    if (p_menu != nullptr)
+        header_length += 2;
+#if MENUSYSTEM_NUMERIC
+    else if (p_numeric_item != nullptr)
+        header_length += 4 * sizeof(float);
+    else if (p_choice_item != nullptr)
+        header_length += 2;
+#endif
+
+    const char* name = component.get_name();
+    uint8_t name_length = clamp_length(strlen(name),
+                                       MENUSTREAM_MAX_PAYLOAD - header_length);
+
+    begin_frame(MenuStream::MSG_NODE, header_length + name_length);
+    // MenuStream::NodeType has the values of MenuComponent::Type
+    write_byte(component.get_type());
+    write_byte(flags);
+    if (p_menu != nullptr) {
+        write_uint16(p_menu->get_num_components());
+    }
+#if MENUSYSTEM_NUMERIC
+    else if (p_numeric_item != nullptr) {
+        write_float(p_numeric_item->get_value());
+        write_float(p_numeric_item->get_min_value());
+        write_float(p_numeric_item->get_max_value());
+        write_float(p_numeric_item->get_increment());
+    } else if (p_choice_item != nullptr) {
+        write_byte(p_choice_item->get_index());
+        write_byte(p_choice_item->get_num_choices());
+    }
+#endif
+    for (uint8_t i = 0; i < name_length; ++i)
+        write_byte(name[i]);
+    end_frame();
+
+#if MENUSYSTEM_NUMERIC
+    if (p_choice_item != nullptr) {
+        for (uint8_t i = 0; i < p_choice_item->get_num_choices(); ++i) {
+            const char* label = (const char*) p_choice_item->get_label(i);
+            uint8_t label_length = 0;
+            while (label_length < MENUSTREAM_MAX_PAYLOAD
+                    && pgm_read_byte(label + label_length) != '\0')
+                label_length++;
+
+            begin_frame(MenuStream::MSG_LABEL, label_length);
+            for (uint8_t j = 0; j < label_length; ++j)
+                write_byte(pgm_read_byte(label + j));
+            end_frame();
+        }
+    }
+#endif
+
+    if (p_menu != nullptr) {
+        for (Menu::ComponentIndex i = 0; i < p_menu->get_num_components(); ++i)
+            send_node(*p_menu->get_menu_component(i), get_flags(*p_menu, i));
+    }
+}
+
+void MenuStreamWriter::send_state(bool force) {
+#if MENUSYSTEM_INSTRUMENTATION
+    _generation = _menu_system.get_generation();
+#endif
+
+    Menu const* p_menu = _menu_system.get_current_menu();
+
+    // The snapshot carries every flag, so afterwards only the menus whose
+    // flags changed since need them sent again. Past half the range of the
+    // generations, which ones changed can't be told apart any more.
+    uint16_t last_flags_generation = Menu::get_last_flags_generation();
+    if (force) {
+        _snapshot_flags_generation = last_flags_generation;
+        _flags_stale = false;
+    }
+    uint16_t num_flags_changes =
+        last_flags_generation - _snapshot_flags_generation;
+    if (num_flags_changes >= 0x8000)
+        _flags_stale = true;
+
+    // A shared menu can be entered again at the same depth through another
+    // parent, so compare the whole path
+    uint8_t depth = _menu_system.get_depth();
+    bool menu_changed = force || p_menu != _p_menu || depth != _depth;
+    for (uint8_t i = 0; !menu_changed && i < depth; ++i)
+        menu_changed = _menu_system.get_entry_component_num(i) != _path[i];
+
+    bool send_all_flags = force;
+    if (menu_changed) {
+        uint8_t path_length = depth;
+        if (path_length > (MENUSTREAM_MAX_PAYLOAD - 1) / 2)
+            path_length = (MENUSTREAM_MAX_PAYLOAD - 1) / 2;
+
+        begin_frame(MenuStream::MSG_MENU, 1 + 2 * path_length);
+        write_byte(path_length);
+        for (uint8_t i = 0; i < path_length; ++i)
+            write_uint16(_menu_system.get_entry_component_num(i));
+        end_frame();
+
+        for (uint8_t i = 0; i < depth; ++i)
+            _path[i] = _menu_system.get_entry_component_num(i);
+        _p_menu = p_menu;
+        _depth = depth;
+        force = true;
+
+        // A shared menu's flags may also have changed while it was current
+        // elsewhere in the mirror
+        uint16_t since_snapshot =
+            p_menu->get_flags_generation() - _snapshot_flags_generation - 1;
+        if (_flags_stale || since_snapshot < num_flags_changes)
+            send_all_flags = true;
+        else
+            _flags_generation = p_menu->get_flags_generation();
+    }
+
+    if (send_all_flags || p_menu->get_flags_generation() != _flags_generation) {
+        send_flags(*p_menu);
+        _flags_generation = p_menu->get_flags_generation();
+    }
+
+    // Navigating never changes focus, but the mirror may hold a stale value
+    // for the newly current component.
+    bool force_value = force;
+    Menu::ComponentIndex cursor = p_menu->get_current_component_num();
+    if (force || cursor != _cursor) {
+        begin_frame(MenuStream::MSG_CURSOR, 2);
+        write_uint16(cursor);
+        end_frame();
+        _cursor = cursor;
+        force_value = true;
+    }
+
+    MenuComponent const* p_component = p_menu->get_current_component();
+    if (p_component == nullptr)
+        return;
+
+    if (force || p_component->has_focus() != _has_focus) {
+        _has_focus = p_component->has_focus();
+        begin_frame(MenuStream::MSG_FOCUS, 1);
+        write_byte(_has_focus);
+        end_frame();
+    }
+
+#if MENUSYSTEM_NUMERIC
+    NumericMenuItem const* p_numeric_item = as_numeric_item(*p_component);
+    ChoiceMenuItem const* p_choice_item = as_choice_item(*p_component);
+    if (p_numeric_item != nullptr) {
+        float value = p_numeric_item->get_value();
+        if (force_value || value != _value) {
+            begin_frame(MenuStream::MSG_VALUE, sizeof(float));
+            write_float(value);
+            end_frame();
+            _value = value;
+        }
+    } else if (p_choice_item != nullptr) {
+        uint8_t choice = p_choice_item->get_index();
+        if (force_value || choice != _choice) {
+            begin_frame(MenuStream::MSG_CHOICE, 1);
+            write_byte(choice);
+            end_frame();
+            _choice = choice;
+        }
+    }
+#else
+    (void) force_value;
+#endif
+}
+
+void MenuStreamWriter::send_flags(Menu const& menu) {
+    const uint8_t max_flags = MENUSTREAM_MAX_PAYLOAD - 2;
+    Menu::ComponentIndex num_components = menu.get_num_components();
+    Menu::ComponentIndex first = 0;
+    while (first < num_components) {
+        Menu::ComponentIndex num_remaining = num_components - first;
+        uint8_t num_flags = num_remaining < max_flags ? num_remaining
+                                                      : max_flags;
+
+        begin_frame(MenuStream::MSG_FLAGS, 2 + num_flags);
+        write_uint16(first);
+        for (uint8_t i = 0; i < num_flags; ++i)
+            write_byte(get_flags(menu, first + i));
+        end_frame();
+        first += num_flags;
+    }
+}
+
+void MenuStreamWriter::begin_frame(MenuStream::MessageType type,
+                                   uint8_t length) {
+    _out.write(MenuStream::SYNC);
+    _checksum = 0;
+    write_byte(type);
+    write_byte(_sequence++);
+    write_byte(length);
+}
+
+void MenuStreamWriter::write_byte(uint8_t value) {
+    _checksum ^= value;
+    _out.write(value);
+}
+
+void MenuStreamWriter::write_uint16(uint16_t value) {
+    write_byte(value & 0xFF);
+    write_byte(value >> 8);
+}
+
+void MenuStreamWriter::write_float(float value) {
+    uint8_t bytes[sizeof(float)];
+    memcpy(bytes, &value, sizeof(float));
+    for (uint8_t i = 0; i < sizeof(float); ++i)
+        write_byte(bytes[i]);
+}
+
+void MenuStreamWriter::end_frame() {
+    _out.write(_checksum);
+}
+
+// *********************************************************
+// MenuStreamReader
+// *********************************************************
+
+MenuStreamReader::MenuStreamReader()
+: _state(STATE_SYNC),
+  _type(0),
+  _sequence(0),
+  _length(0),
+  _received(0),
+  _checksum(0),
+  _next_sequence(0),
+  _has_sequence(false),
+  _needs_resync(true) {
+}
+
+bool MenuStreamReader::read(uint8_t byte) {
+    switch (_state) {
+        case STATE_SYNC:
+            if (byte == MenuStream::SYNC)
+                _state = STATE_TYPE;
+            else
+                _needs_resync = true;
+            return false;
+        case STATE_TYPE:
+            _type = byte;
+            _checksum = byte;
+            _state = STATE_SEQUENCE;
+            return false;
+        case STATE_SEQUENCE:
+            _sequence = byte;
+            _checksum ^= byte;
+            _state = STATE_LENGTH;
+            return false;
+        case STATE_LENGTH:
+            _length = byte;
+            _checksum ^= byte;
+            _received = 0;
+            if (_length > MENUSTREAM_MAX_PAYLOAD) {
+                _needs_resync = true;
+                _state = STATE_SYNC;
+            } else {
+                _state = _length ? STATE_PAYLOAD : STATE_CHECKSUM;
+            }
+            return false;
+        case STATE_PAYLOAD:
+            _payload[_received++] = byte;
+            _checksum ^= byte;
+            if (_received == _length)
+                _state = STATE_CHECKSUM;
+            return false;
+        case STATE_CHECKSUM:
+            _state = STATE_SYNC;
+            if (byte != _checksum) {
+                _needs_resync = true;
+                return false;
+            }
+            break;
+    }
+
+    if (_type == MenuStream::MSG_SNAPSHOT_BEGIN)
+        _needs_resync = false;
+    else if (_has_sequence && _sequence != _next_sequence)
+        _needs_resync = true;
+
+    _has_sequence = true;
+    _next_sequence = _sequence + 1;
+    return true;
+}
+
+bool MenuStreamReader::needs_resync() const {
+    return _needs_resync;
+}
+
+MenuStream::MessageType MenuStreamReader::get_type() const {
+    return (MenuStream::MessageType) _type;
+}
+
+uint8_t MenuStreamReader::get_sequence() const {
+    return _sequence;
+}
+
+uint8_t MenuStreamReader::get_length() const {
+    return _length;
+}
+
+uint8_t const* MenuStreamReader::get_payload() const {
+    return _payload;
+}
+
+uint8_t MenuStreamReader::get_uint8(uint8_t offset) const {
+    return _payload[offset];
+}
+
+uint16_t MenuStreamReader::get_uint16(uint8_t offset) const {
+    return _payload[offset] | ((uint16_t) _payload[offset + 1] << 8);
+}
+
+float MenuStreamReader::get_float(uint8_t offset) const {
+    float value;
+    memcpy(&value, _payload + offset, sizeof(float));
+    return value;
+}
+
+// *********************************************************
+// MenuStreamMirror
+// *********************************************************
+
+MenuStreamMirror::MenuStreamMirror(Node* nodes, uint16_t max_nodes,
+                                   char* text, uint16_t text_size)
+: _nodes(nodes),
+  _max_nodes(max_nodes),
+  _num_nodes(0),
+  _text(text),
+  _text_size(text_size),
+  _text_used(0),
+  _stack_depth(0),
+  _loading(false),
+  _valid(false),
+  _menu(0),
+  _depth(0),
+  _cursor(0),
+  _has_focus(false) {
+}
+
+bool MenuStreamMirror::read(uint8_t byte) {
+    if (!_reader.read(byte))
+        return false;
+
+    uint8_t length = _reader.get_length();
+    switch (_reader.get_type()) {
+        case MenuStream::MSG_SNAPSHOT_BEGIN:
+            _num_nodes = 0;
+            _text_used = 0;
+            _stack_depth = 0;
+            _loading = true;
+            _valid = true;
+            _menu = 0;
+            _depth = 0;
+            _cursor = 0;
+            _has_focus = false;
+            return true;
+        case MenuStream::MSG_NODE:
+            if (!_loading || !_valid)
+                return false;
+            apply_node();
+            return _valid;
+        case MenuStream::MSG_LABEL:
+            if (!_loading || !_valid)
+                return false;
+            apply_label();
+            return _valid;
+        case MenuStream::MSG_SNAPSHOT_END:
+            if (!_loading)
+                return false;
+            _loading = false;
+            if (_stack_depth > 0 || _num_nodes == 0)
+                _valid = false;
+            return _valid;
+        default:
+            break;
+    }
+
+    // The state only applies to a complete tree
+    if (_loading || !_valid)
+        return false;
+
+    uint16_t component = get_current_component();
+    switch (_reader.get_type()) {
+        case MenuStream::MSG_MENU:
+            apply_menu();
+            return _valid;
+        case MenuStream::MSG_CURSOR:
+            if (length < 2)
+                return false;
+            _cursor = _reader.get_uint16(0);
+            return true;
+        case MenuStream::MSG_FOCUS:
+            if (length < 1)
+                return false;
+            _has_focus = _reader.get_uint8(0) != 0;
+            return true;
+        case MenuStream::MSG_VALUE:
+            if (length < sizeof(float) || component == NO_NODE
+                    || _nodes[component].type != MenuStream::NODE_NUMERIC_ITEM)
+                return false;
+            _nodes[component].value = _reader.get_float(0);
+            return true;
+        case MenuStream::MSG_CHOICE:
+            if (length < 1 || component == NO_NODE
+                    || _nodes[component].type != MenuStream::NODE_CHOICE_ITEM)
+                return false;
+            _nodes[component].choice = _reader.get_uint8(0);
+            return true;
+        case MenuStream::MSG_FLAGS:
+            if (length < 2)
+                return false;
+            apply_flags();
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool MenuStreamMirror::needs_resync() const {
+    return _reader.needs_resync();
+}
+
+bool MenuStreamMirror::is_valid() const {
+    return _valid && !_loading && !_reader.needs_resync();
+}
+
+uint16_t MenuStreamMirror::get_num_nodes() const {
+    return _num_nodes;
+}
+
+MenuStreamMirror::Node const& MenuStreamMirror::get_node(uint16_t index) const {
+    return _nodes[index];
+}
+
+const char* MenuStreamMirror::get_name(uint16_t index) const {
+    return _text + _nodes[index].name;
+}
+
+const char* MenuStreamMirror::get_label(uint16_t index, uint8_t choice) const {
+    Node const& node = _nodes[index];
+    if (node.type != MenuStream::NODE_CHOICE_ITEM || choice >= node.num_choices)
+        return "";
+
+    // Labels that weren't received read as empty
+    uint16_t offset = node.labels;
+    for (uint8_t i = 0; i < choice && offset < _text_used; ++i)
+        offset += strlen(_text + offset) + 1;
+    return offset < _text_used ? _text + offset : "";
+}
+
+uint16_t MenuStreamMirror::get_child(uint16_t index, uint16_t num) const {
+    if (index >= _num_nodes || _nodes[index].type != MenuStream::NODE_MENU)
+        return NO_NODE;
+
+    uint16_t child = _nodes[index].first_child;
+    while (num-- > 0 && child != NO_NODE)
+        child = _nodes[child].next_sibling;
+    return child;
+}
+
+uint16_t MenuStreamMirror::get_current_menu() const {
+    return _menu;
+}
+
+uint8_t MenuStreamMirror::get_depth() const {
+    return _depth;
+}
+
+uint16_t MenuStreamMirror::get_current_component_num() const {
+    return _cursor;
+}
+
+uint16_t MenuStreamMirror::get_current_component() const {
+    return get_child(_menu, _cursor);
+}
+
+bool MenuStreamMirror::has_focus() const {
+    return _has_focus;
+}
+
+void MenuStreamMirror::apply_node() {
+    uint8_t length = _reader.get_length();
+    if (length < 2 || _num_nodes == _max_nodes) {
+        _valid = false;
+        return;
+    }
+
+    Node& node = _nodes[_num_nodes];
+    memset(&node, 0, sizeof(node));
+    node.type = (MenuStream::NodeType) _reader.get_uint8(0);
+    node.flags = _reader.get_uint8(1);
+    node.first_child = NO_NODE;
+    node.next_sibling = NO_NODE;
+
+    uint8_t offset = 2;
+    if (node.type == MenuStream::NODE_MENU) {
+        offset += 2;
+        if (offset <= length)
+            node.num_children = _reader.get_uint16(2);
+    } else if (node.type == MenuStream::NODE_NUMERIC_ITEM) {
+        offset += 4 * sizeof(float);
+        if (offset <= length) {
+            node.value = _reader.get_float(2);
+            node.min_value = _reader.get_float(2 + sizeof(float));
+            node.max_value = _reader.get_float(2 + 2 * sizeof(float));
+            node.increment = _reader.get_float(2 + 3 * sizeof(float));
+        }
+    } else if (node.type == MenuStream::NODE_CHOICE_ITEM) {
+        offset += 2;
+        if (offset <= length) {
+            node.choice = _reader.get_uint8(2);
+            node.num_choices = _reader.get_uint8(3);
+        }
+    }
+    if (offset > length) {
+        _valid = false;
+        return;
+    }
+
+    node.name = add_text(offset);
+    node.labels = _text_used;
+    if (node.name == NO_NODE) {
+        _valid = false;
+        return;
+    }
+
+    uint16_t index = _num_nodes++;
+    if (_stack_depth > 0) {
+        Frame& frame = _stack[_stack_depth - 1];
+        if (frame.last_child == NO_NODE)
+            _nodes[frame.menu].first_child = index;
+        else
+            _nodes[frame.last_child].next_sibling = index;
+        frame.last_child = index;
+        --frame.num_remaining;
+    } else if (index > 0) {
+        // Only the root menu has no parent
+        _valid = false;
+        return;
+    }
+
+    if (node.type == MenuStream::NODE_MENU && node.num_children > 0) {
+        if (_stack_depth == sizeof(_stack) / sizeof(_stack[0])) {
+            _valid = false;
+            return;
+        }
+        Frame& frame = _stack[_stack_depth++];
+        frame.menu = index;
+        frame.last_child = NO_NODE;
+        frame.num_remaining = node.num_children;
+    }
+
+    while (_stack_depth > 0 && _stack[_stack_depth - 1].num_remaining == 0)
+        --_stack_depth;
+}
+
+void MenuStreamMirror::apply_label() {
+    if (_num_nodes == 0
+            || _nodes[_num_nodes - 1].type != MenuStream::NODE_CHOICE_ITEM
+            || add_text(0) == NO_NODE)
+        _valid = false;
+}
+
+void MenuStreamMirror::apply_menu() {
+    uint8_t length = _reader.get_length();
+    uint8_t depth = length > 0 ? _reader.get_uint8(0) : 0;
+    if (length < 1 + 2 * depth) {
+        _valid = false;
+        return;
+    }
+
+    uint16_t menu = 0;
+    for (uint8_t i = 0; i < depth; ++i) {
+        menu = get_child(menu, _reader.get_uint16(1 + 2 * i));
+        if (menu == NO_NODE || _nodes[menu].type != MenuStream::NODE_MENU) {
+            _valid = false;
+            return;
+        }
+    }
+    _menu = menu;
+    _depth = depth;
+}
+
+void MenuStreamMirror::apply_flags() {
+    uint16_t child = get_child(_menu, _reader.get_uint16(0));
+    for (uint8_t i = 2; i < _reader.get_length() && child != NO_NODE; ++i) {
+        _nodes[child].flags = _reader.get_uint8(i);
+        child = _nodes[child].next_sibling;
+    }
+}
+
+uint16_t MenuStreamMirror::add_text(uint8_t offset) {
+    uint8_t length = _reader.get_length() - offset;
+    if (_text_size - _text_used < length + 1)
+        return NO_NODE;
+
+    uint16_t start = _text_used;
+    memcpy(_text + start, _reader.get_payload() + offset, length);
+    _text[start + length] = '\0';
+    _text_used += length + 1;
+    return start;
+}
@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#ifndef MENUSTREAM_H
+#define MENUSTREAM_H
+
+#include "MenuSystem.h"
+
+//! \brief The maximum payload of a MenuStream frame
+//!
+//! Longer component names are truncated to fit. Define it in the build flags
+//! to override the default.
+#ifndef MENUSTREAM_MAX_PAYLOAD
+  #define MENUSTREAM_MAX_PAYLOAD 48
+#endif
+
+//! \brief Constants of the menu streaming protocol
+//!
+//! The protocol mirrors a MenuSystem on a remote peer over a byte stream such
+//! as a serial port. The device sends a snapshot of the menu tree once and
+//! then only the changes to its state.
+//!
+//! Every message is a frame:
+//!
+//!     SYNC TYPE SEQ LEN PAYLOAD[LEN] CHECKSUM
+//!
+//! SEQ increases by one with every frame so a peer can detect lost frames and
+//! request a new snapshot. CHECKSUM is the XOR of TYPE, SEQ, LEN and the
+//! payload. Multi-byte integers and floats (IEEE-754) are little-endian.
+//!
+//! A snapshot is MSG_SNAPSHOT_BEGIN, one MSG_NODE per component in depth-first
+//! order (a menu's children follow it, a choice item's MSG_LABELs follow it),
+//! MSG_SNAPSHOT_END and finally the full state as delta messages.
+//!
+//! \see MenuStreamWriter
+//! \see MenuStreamReader
+//! \see MenuStreamMirror
+class MenuStream {
+public:
+    static const uint8_t SYNC = 0xA5;
+
+    enum MessageType : uint8_t {
+        //! Starts a snapshot. No payload.
+        MSG_SNAPSHOT_BEGIN = 1,
+        //! A component: NodeType, NodeFlags, type specific fields, then the
+        //! name.
+        //!   NODE_MENU:         uint16 number of children
+        //!   NODE_NUMERIC_ITEM: float value, min, max and increment
+        //!   NODE_CHOICE_ITEM:  uint8 index, uint8 number of choices
+        MSG_NODE = 2,
+        //! A label of the preceding choice item.
+        MSG_LABEL = 3,
+        //! Ends a snapshot. No payload.
+        MSG_SNAPSHOT_END = 4,
+        //! The current menu: uint8 depth, then the uint16 index of the
+        //! component entered at each level starting from the root menu.
+        MSG_MENU = 5,
+        //! The current component number of the current menu: uint16.
+        MSG_CURSOR = 6,
+        //! Whether the current component has focus: uint8.
+        MSG_FOCUS = 7,
+        //! The value of the current numeric item: float.
+        MSG_VALUE = 8,
+        //! The index of the current choice item: uint8.
+        MSG_CHOICE = 9,
+        //! The NodeFlags of components of the current menu: uint16 number
+        //! of the first component, then one uint8 per component. Sent for
+        //! all the components when the flags of the current menu change, or
+        //! when a menu whose flags changed since the snapshot becomes
+        //! current; a long menu takes several frames.
+        MSG_FLAGS = 10
+    };
+
+    //! Same values as MenuComponent::Type.
+    enum NodeType : uint8_t {
+        NODE_ITEM = 0,
+        NODE_BACK_ITEM = 1,
+        NODE_NUMERIC_ITEM = 2,
+        NODE_CHOICE_ITEM = 3,
+        NODE_MENU = 4
+    };
+
+    //! Same values as MenuBlob::NodeFlags.
+    enum NodeFlags : uint8_t {
+        FLAG_HIDDEN = 0x01,
+        FLAG_DISABLED = 0x02
+    };
+};
+
+
+//! \brief Streams the state of a MenuSystem to a remote mirror
+//!
+//! Call MenuStreamWriter::send_snapshot once (and whenever the mirror asks
+//! to resync) and MenuStreamWriter::update after input has been handed to
+//! the MenuSystem. Only what changed is sent, so a keypress costs a single
+//! small frame.
+//!
+//! Deltas describe the current menu: the flags of its components (see
+//! Menu::set_component_visible and Menu::set_component_enabled) and the state
+//! of its current component. The flags of a menu are sent again when it
+//! becomes current only if they changed since the snapshot, which holds as
+//! long as MenuStreamWriter::update runs at least once every 32768 changes of
+//! the flags; other changes made by the application (e.g.
+//! NumericMenuItem::set_value) reach the mirror with the next snapshot.
+//!
+//! Components are described by MenuComponent::get_type, so a custom
+//! component is streamed as the library class it derives from.
+//!
+//! \see MenuStream
+class MenuStreamWriter {
+public:
+    //! \brief Construct a MenuStreamWriter
+    //! \param[in] menu_system The menu system to stream.
+    //! \param[in] out Where to write the frames, e.g. Serial.
+    MenuStreamWriter(MenuSystem const& menu_system, Print& out);
+
+    //! \brief Sends the whole menu tree followed by its current state
+    void send_snapshot();
+
+    //! \brief Sends the state that changed since the last call
+    //!
+    //! Does nothing when the MenuSystem generation is unchanged.
+    void update();
+
+private:
+    void send_node(MenuComponent const& component, uint8_t flags);
+    void send_flags(Menu const& menu);
+    void send_state(bool force);
+
+    void begin_frame(MenuStream::MessageType type, uint8_t length);
+    void write_byte(uint8_t value);
+    void write_uint16(uint16_t value);
+    void write_float(float value);
+    void end_frame();
+
+private:
+    MenuSystem const& _menu_system;
+    Print& _out;
+    uint8_t _sequence;
+    uint8_t _checksum;
+#if MENUSYSTEM_INSTRUMENTATION
+    uint16_t _generation;
+#endif
+    Menu const* _p_menu;
+    uint8_t _depth;
+    Menu::ComponentIndex _path[MENUSYSTEM_MAX_DEPTH];
+    uint16_t _flags_generation;
+    uint16_t _snapshot_flags_generation;
+    bool _flags_stale;
+    Menu::ComponentIndex _cursor;
+    bool _has_focus;
+#if MENUSYSTEM_NUMERIC
+    float _value;
+    uint8_t _choice;
+#endif
+};
+
+
+//! \brief Parses the frames sent by a MenuStreamWriter
+//!
+//! Feed it the received bytes one at a time. When MenuStreamReader::read
+//! returns true a complete, valid frame is available through the getters
+//! until the next byte is fed.
+//!
+//! \see MenuStream
+class MenuStreamReader {
+public:
+    MenuStreamReader();
+
+    //! \brief Processes a received byte
+    //! \returns true if the byte completed a valid frame, false otherwise.
+    bool read(uint8_t byte);
+
+    //! \brief Returns true if frames were lost or corrupted since the last
+    //!        snapshot started
+    //!
+    //! The mirror is out of sync and should ask the device for a snapshot.
+    bool needs_resync() const;
+
+    MenuStream::MessageType get_type() const;
+    uint8_t get_sequence() const;
+    uint8_t get_length() const;
+    uint8_t const* get_payload() const;
+
+    uint8_t get_uint8(uint8_t offset) const;
+    uint16_t get_uint16(uint8_t offset) const;
+    float get_float(uint8_t offset) const;
+
+private:
+    enum State : uint8_t {
+        STATE_SYNC,
+        STATE_TYPE,
+        STATE_SEQUENCE,
+        STATE_LENGTH,
+        STATE_PAYLOAD,
+        STATE_CHECKSUM
+    };
+
+private:
+    uint8_t _payload[MENUSTREAM_MAX_PAYLOAD];
+    State _state;
+    uint8_t _type;
+    uint8_t _sequence;
+    uint8_t _length;
+    uint8_t _received;
+    uint8_t _checksum;
+    uint8_t _next_sequence;
+    bool _has_sequence;
+    bool _needs_resync;
+};
+
+
+//! \brief Rebuilds the menu tree and state sent by a MenuStreamWriter
+//!
+//! Feed it the received bytes one at a time; it parses them with a
+//! MenuStreamReader and applies the frames. The tree is kept in storage
+//! supplied by the client: one Node per component and a text buffer for the
+//! names and choice labels.
+//!
+//! \code
+//! MenuStreamMirror::Node nodes[32];
+//! char text[256];
+//! MenuStreamMirror mirror(nodes, 32, text, sizeof(text));
+//!
+//! void loop() {
+//!     while (Serial.available())
+//!         if (mirror.read(Serial.read()))
+//!             redraw();
+//!     if (mirror.needs_resync())
+//!         request_snapshot();
+//! }
+//! \endcode
+//!
+//! \see MenuStream
+class MenuStreamMirror {
+public:
+    //! Returned for a component that doesn't exist.
+    static const uint16_t NO_NODE = 0xFFFF;
+
+    //! \brief A component of the mirrored tree
+    struct Node {
+        MenuStream::NodeType type;
+        //! MenuStream::NodeFlags of the component in its menu.
+        uint8_t flags;
+        //! NODE_MENU: the number of children.
+        uint16_t num_children;
+        //! NODE_MENU: the first child, or NO_NODE.
+        uint16_t first_child;
+        //! The next child of the same menu, or NO_NODE.
+        uint16_t next_sibling;
+        //! Offset of the name in the text buffer.
+        uint16_t name;
+        //! NODE_NUMERIC_ITEM: value, min, max and increment.
+        float value;
+        float min_value;
+        float max_value;
+        float increment;
+        //! NODE_CHOICE_ITEM: the index of the current choice.
+        uint8_t choice;
+        //! NODE_CHOICE_ITEM: the number of choices.
+        uint8_t num_choices;
+        //! NODE_CHOICE_ITEM: offset of the first label in the text buffer;
+        //! the labels follow each other.
+        uint16_t labels;
+    };
+
+public:
+    //! \brief Construct a MenuStreamMirror
+    //!
+    //! \param[in] nodes Storage for the components.
+    //! \param[in] max_nodes The number of elements in nodes.
+    //! \param[in] text Storage for the names and labels.
+    //! \param[in] text_size The size of text in bytes.
+    MenuStreamMirror(Node* nodes, uint16_t max_nodes, char* text,
+                     uint16_t text_size);
+
+    //! \brief Processes a received byte
+    //! \returns true if the byte completed a frame that was applied.
+    bool read(uint8_t byte);
+
+    //! \brief Returns true if frames were lost or corrupted since the last
+    //!        snapshot started
+    //!
+    //! \see MenuStreamReader::needs_resync
+    bool needs_resync() const;
+
+    //! \brief Returns true if the mirror holds a complete snapshot and no
+    //!        frame was lost since
+    //!
+    //! A snapshot that doesn't fit the storage, or nests menus deeper than
+    //! MENUSYSTEM_MAX_DEPTH, leaves the mirror invalid.
+    bool is_valid() const;
+
+    //! \brief Returns the number of nodes in use
+    uint16_t get_num_nodes() const;
+
+    //! \brief Returns the node at index; the root menu is node 0
+    Node const& get_node(uint16_t index) const;
+
+    //! \brief Returns the name of the node at index
+    const char* get_name(uint16_t index) const;
+
+    //! \brief Returns the label of a choice of the choice item at index
+    const char* get_label(uint16_t index, uint8_t choice) const;
+
+    //! \brief Returns the child number num of the menu at index, or NO_NODE
+    uint16_t get_child(uint16_t index, uint16_t num) const;
+
+    //! \brief Returns the current menu
+    uint16_t get_current_menu() const;
+
+    //! \brief Returns the depth of the current menu
+    //! \see MenuSystem::get_depth
+    uint8_t get_depth() const;
+
+    //! \brief Returns the current component number of the current menu
+    uint16_t get_current_component_num() const;
+
+    //! \brief Returns the current component of the current menu, or NO_NODE
+    uint16_t get_current_component() const;
+
+    //! \brief Returns true if the current component has focus
+    bool has_focus() const;
+
+private:
+    struct Frame {
+        uint16_t menu;
+        uint16_t last_child;
+        uint16_t num_remaining;
+    };
+
+private:
+    void apply_node();
+    void apply_label();
+    void apply_menu();
+    void apply_flags();
+    uint16_t add_text(uint8_t offset);
+
+private:
+    MenuStreamReader _reader;
+    Node* _nodes;
+    uint16_t _max_nodes;
+    uint16_t _num_nodes;
+    char* _text;
+    uint16_t _text_size;
+    uint16_t _text_used;
+    Frame _stack[MENUSYSTEM_MAX_DEPTH + 1];
+    uint8_t _stack_depth;
+    bool _loading;
+    bool _valid;
+    uint16_t _menu;
+    uint8_t _depth;
+    uint16_t _cursor;
+    bool _has_focus;
+};
+
+#endif
@@ -11,10 +11,17 @@
 // MenuComponent
 // *********************************************************
 
+#if MENUSYSTEM_INSTRUMENTATION
+uint16_t MenuComponent::_generation = 0;
+#endif
+
 MenuComponent::MenuComponent(const char* name, SelectFnPtr select_fn)
 : _name(name),
+#if MENUSYSTEM_NUMERIC
   _has_focus(false),
+#endif
   _is_current(false),
+  _name_version(0),
   _select_fn(select_fn) {
 }
 
@@ -24,10 +31,20 @@ const char* MenuComponent::get_name() const {
 
 void MenuComponent::set_name(const char* name) {
     _name = name;
+    _name_version++;
+    changed();
+}
+
+uint8_t MenuComponent::get_name_version() const {
+    return _name_version;
 }
 
 bool MenuComponent::has_focus() const {
+#if MENUSYSTEM_NUMERIC
     return _has_focus;
+#else
+    return false;
+#endif
 }
 
 bool MenuComponent::is_current() const {
@@ -35,9 +52,18 @@ bool MenuComponent::is_current() const {
 }
 
 void MenuComponent::set_current(bool is_current) {
-    _is_current = is_current;
+    if (_is_current != is_current) {
+        _is_current = is_current;
+        changed();
+    }
 }
 
+#if MENUSYSTEM_INSTRUMENTATION
+void MenuComponent::changed() {
+    _generation++;
+}
+#endif
+
 Menu* MenuComponent::select() {
     if (_select_fn != nullptr)
         _select_fn(this);
@@ -45,6 +71,16 @@ Menu* MenuComponent::select() {
     return nullptr;
 }
 
+#if MENUSYSTEM_NUMERIC
+bool MenuComponent::back() {
+    return false;
+}
+
+void MenuComponent::update() {
+    // Do nothing.
+}
+#endif
+
 void MenuComponent::set_select_function(SelectFnPtr select_fn) {
     _select_fn = select_fn;
 }
@@ -53,69 +89,210 @@ void MenuComponent::set_select_function(SelectFnPtr select_fn) {
 // Menu
 // *********************************************************
 
+uint16_t Menu::_last_flags_generation = 0;
+
 Menu::Menu(const char* name, SelectFnPtr select_fn)
 : MenuComponent(name, select_fn),
   _p_current_component(nullptr),
   _menu_components(nullptr),
+  _visible_mask(nullptr),
+  _enabled_mask(nullptr),
   _p_parent(nullptr),
   _num_components(0),
+  _num_visible_components(0),
+  _capacity(0),
   _current_component_num(0),
-  _previous_component_num(0) {
+  _previous_component_num(0),
+  _flags_generation(0) {
 }
 
 bool Menu::next(bool loop) {
     _previous_component_num = _current_component_num;
 
-    if (!_num_components) {
+    if (!_num_components)
         return false;
-    } else if (_current_component_num != _num_components - 1) {
-        _current_component_num++;
-        _p_current_component = _menu_components[_current_component_num];
-
-        _p_current_component->set_current();
-        _menu_components[_previous_component_num]->set_current(false);
-        return true;
-    } else if (loop) {
-        _current_component_num = 0;
-        _p_current_component = _menu_components[_current_component_num];
-
-        _p_current_component->set_current();
-        _menu_components[_previous_component_num]->set_current(false);
 
-        return true;
+    ComponentIndex index;
+    if (!find_next_visible((size_t) _current_component_num + 1, index)) {
+        if (!(MENUSYSTEM_LOOP && loop) || !find_next_visible(0, index))
+            return false;
     }
-    return false;
+    if (index == _current_component_num)
+        return false;
+
+    set_current_component_num(index);
+    return true;
 }
 
 bool Menu::prev(bool loop) {
     _previous_component_num = _current_component_num;
 
-    if (!_num_components) {
+    if (!_num_components)
         return false;
-    } else if (_current_component_num != 0) {
-        _current_component_num--;
-        _p_current_component = _menu_components[_current_component_num];
 
-        _p_current_component->set_current();
-        _menu_components[_previous_component_num]->set_current(false);
+    ComponentIndex index;
+    if (_current_component_num == 0
+            || !find_prev_visible(_current_component_num - 1, index)) {
+        if (!(MENUSYSTEM_LOOP && loop)
+                || !find_prev_visible(_num_components - 1, index))
+            return false;
+    }
+    if (index == _current_component_num)
+        return false;
 
-        return true;
-    } else if (loop) {
-        _current_component_num = _num_components - 1;
-        _p_current_component = _menu_components[_current_component_num];
+    set_current_component_num(index);
+    return true;
+}
 
-        _p_current_component->set_current();
-        _menu_components[_previous_component_num]->set_current(false);
+size_t Menu::get_num_mask_words(size_t num_components) {
+    return (num_components + MASK_WORD_BITS - 1) / MASK_WORD_BITS;
+}
 
-        return true;
+bool Menu::get_mask_bit(MaskWord const* mask, ComponentIndex index) {
+    return (mask[index / MASK_WORD_BITS] >> (index % MASK_WORD_BITS)) & 1;
+}
+
+void Menu::set_mask_bit(MaskWord* mask, ComponentIndex index, bool value) {
+    MaskWord bit = (MaskWord) 1 << (index % MASK_WORD_BITS);
+    if (value)
+        mask[index / MASK_WORD_BITS] |= bit;
+    else
+        mask[index / MASK_WORD_BITS] &= ~bit;
+}
+
+bool Menu::find_next_visible(size_t from, ComponentIndex& index) const {
+    if (from >= _num_components)
+        return false;
+
+    // Bits past _num_components are always clear, so scanning whole words
+    // never finds a component that doesn't exist.
+    size_t num_words = get_num_mask_words(_num_components);
+    size_t word = from / MASK_WORD_BITS;
+    MaskWord bits = _visible_mask[word] & (~(MaskWord) 0 << (from % MASK_WORD_BITS));
+    while (!bits) {
+        if (++word == num_words)
+            return false;
+        bits = _visible_mask[word];
     }
-    return false;
+
+    index = word * MASK_WORD_BITS + __builtin_ctz(bits);
+    return true;
+}
+
+bool Menu::find_prev_visible(size_t from, ComponentIndex& index) const {
+    if (from >= _num_components)
+        return false;
+
+    size_t word = from / MASK_WORD_BITS;
+    uint8_t bit = from % MASK_WORD_BITS;
+    MaskWord bits = _visible_mask[word] & (~(MaskWord) 0 >> (MASK_WORD_BITS - 1 - bit));
+    while (!bits) {
+        if (word == 0)
+            return false;
+        bits = _visible_mask[--word];
+    }
+
+    index = word * MASK_WORD_BITS + (MASK_WORD_BITS - 1 - __builtin_clz(bits));
+    return true;
+}
+
+void Menu::set_component_visible(ComponentIndex index, bool visible) {
+    if (index >= _num_components || is_component_visible(index) == visible)
+        return;
+
+    set_mask_bit(_visible_mask, index, visible);
+    if (visible)
+        _num_visible_components++;
+    else
+        _num_visible_components--;
+    _flags_generation = ++_last_flags_generation;
+    changed();
+
+    // The cursor only rests on a hidden component while none is visible
+    if (!visible && index == _current_component_num) {
+        ComponentIndex current;
+        if (find_next_visible((size_t) index + 1, current)
+                || find_prev_visible(index, current))
+            set_current_component_num(current);
+    } else if (visible && !is_component_visible(_current_component_num)) {
+        set_current_component_num(index);
+    }
+}
+
+bool Menu::is_component_visible(ComponentIndex index) const {
+    return get_mask_bit(_visible_mask, index);
+}
+
+void Menu::set_component_enabled(ComponentIndex index, bool enabled) {
+    if (index >= _num_components || is_component_enabled(index) == enabled)
+        return;
+
+    set_mask_bit(_enabled_mask, index, enabled);
+    _flags_generation = ++_last_flags_generation;
+    changed();
+}
+
+bool Menu::is_component_enabled(ComponentIndex index) const {
+    return get_mask_bit(_enabled_mask, index);
+}
+
+uint16_t Menu::get_flags_generation() const {
+    return _flags_generation;
+}
+
+uint16_t Menu::get_last_flags_generation() {
+    return _last_flags_generation;
+}
+
+Menu::ComponentIndex Menu::get_num_visible_components() const {
+    return _num_visible_components;
+}
+
+MenuComponent const* Menu::get_visible_component(ComponentIndex visible_index) const {
+    if (visible_index >= _num_visible_components)
+        return nullptr;
+
+    size_t word = 0;
+    MaskWord bits = _visible_mask[0];
+    uint8_t count = __builtin_popcount(bits);
+    while (visible_index >= count) {
+        visible_index -= count;
+        bits = _visible_mask[++word];
+        count = __builtin_popcount(bits);
+    }
+
+    // Drop the lower visible components of the word
+    while (visible_index--)
+        bits &= bits - 1;
+
+    return _menu_components[word * MASK_WORD_BITS + __builtin_ctz(bits)];
+}
+
+bool Menu::get_next_visible_component_num(size_t from,
+                                          ComponentIndex& index) const {
+    return find_next_visible(from, index);
+}
+
+Menu::ComponentIndex Menu::get_current_visible_component_num() const {
+    size_t word = _current_component_num / MASK_WORD_BITS;
+    ComponentIndex visible_index = 0;
+    for (size_t i = 0; i < word; ++i)
+        visible_index += __builtin_popcount(_visible_mask[i]);
+
+    MaskWord below = ((MaskWord) 1 << (_current_component_num % MASK_WORD_BITS)) - 1;
+    return visible_index + __builtin_popcount(_visible_mask[word] & below);
 }
 
 Menu* Menu::activate() {
     if (!_num_components)
         return nullptr;
 
+    // Disabled components can't be selected, nor can hidden ones when the
+    // whole menu is hidden
+    if (!is_component_enabled(_current_component_num)
+            || !is_component_visible(_current_component_num))
+        return nullptr;
+
     MenuComponent* pComponent = _menu_components[_current_component_num];
 
     if (pComponent == nullptr)
@@ -130,14 +307,16 @@ Menu* Menu::select() {
 }
 
 void Menu::reset() {
-    for (int i = 0; i < _num_components; ++i)
+    for (ComponentIndex i = 0; i < _num_components; ++i)
         _menu_components[i]->reset();
 
-    _p_current_component->set_current(false);
+    if (!_num_components)
+        return;
+
+    ComponentIndex index = 0;
+    find_next_visible(0, index);
+    set_current_component_num(index);
     _previous_component_num = 0;
-    _current_component_num = 0;
-    _p_current_component = _num_components ? _menu_components[0] : nullptr;
-    _p_current_component->set_current();
 }
 
 void Menu::add_item(MenuItem* p_item) {
@@ -149,16 +328,83 @@ void Menu::add_menu(Menu* p_menu) {
     p_menu->set_parent(this);
 }
 
+bool Menu::reserve(ComponentIndex num_components) {
+    if (num_components <= _capacity)
+        return true;
+
+    // Resize menu component list and masks, keeping existing items. A list
+    // that grew before a later allocation failed is kept; it's only larger
+    // than _capacity says.
+    MenuComponent** menu_components;
+    menu_components = (MenuComponent**) realloc(_menu_components,
+                                                num_components
+                                                * sizeof(MenuComponent*));
+    if (menu_components == nullptr)
+        return false;
+    _menu_components = menu_components;
+
+    size_t num_words = get_num_mask_words(_capacity);
+    size_t new_num_words = get_num_mask_words(num_components);
+    if (new_num_words != num_words) {
+        MaskWord* visible_mask;
+        visible_mask = (MaskWord*) realloc(_visible_mask,
+                                           new_num_words * sizeof(MaskWord));
+        if (visible_mask == nullptr)
+            return false;
+        _visible_mask = visible_mask;
+
+        MaskWord* enabled_mask;
+        enabled_mask = (MaskWord*) realloc(_enabled_mask,
+                                           new_num_words * sizeof(MaskWord));
+        if (enabled_mask == nullptr)
+            return false;
+        _enabled_mask = enabled_mask;
+
+        for (size_t i = num_words; i < new_num_words; ++i) {
+            _visible_mask[i] = 0;
+            _enabled_mask[i] = 0;
+        }
+    }
+
+    _capacity = num_components;
+    return true;
+}
+
+void Menu::release() {
+    free(_menu_components);
+    free(_visible_mask);
+    free(_enabled_mask);
+    _menu_components = nullptr;
+    _visible_mask = nullptr;
+    _enabled_mask = nullptr;
+    _p_current_component = nullptr;
+    _num_components = 0;
+    _num_visible_components = 0;
+    _capacity = 0;
+    _current_component_num = 0;
+    _previous_component_num = 0;
+}
+
 void Menu::add_component(MenuComponent* p_component) {
-    // Resize menu component list, keeping existing items.
-    // If it fails, there the item is not added and the function returns.
-    _menu_components = (MenuComponent**) realloc(_menu_components,
-                                                 (_num_components + 1)
-                                                 * sizeof(MenuComponent*));
-    if (_menu_components == nullptr)
-      return;
+    const ComponentIndex max_components = (ComponentIndex) ~(ComponentIndex) 0;
+
+    // Grow the list geometrically so adding n components costs O(n). If it
+    // fails the item is not added and the function returns.
+    if (_num_components == _capacity) {
+        if (_num_components == max_components)
+            return;
+
+        ComponentIndex capacity = _capacity < max_components / 2
+                                  ? _capacity * 2 + 1 : max_components;
+        if (!reserve(capacity))
+            return;
+    }
 
     _menu_components[_num_components] = p_component;
+    set_mask_bit(_visible_mask, _num_components, true);
+    set_mask_bit(_enabled_mask, _num_components, true);
+    _num_visible_components++;
+    changed();
 
     if (_num_components == 0) {
         _p_current_component = p_component;
@@ -166,6 +412,10 @@ void Menu::add_component(MenuComponent* p_component) {
     }
 
     _num_components++;
+
+    // Leave a hidden current component for the first visible one
+    if (!is_component_visible(_current_component_num))
+        set_current_component_num(_num_components - 1);
 }
 
 Menu const* Menu::get_parent() const {
@@ -176,7 +426,19 @@ void Menu::set_parent(Menu* p_parent) {
     _p_parent = p_parent;
 }
 
-MenuComponent const* Menu::get_menu_component(uint8_t index) const {
+void Menu::set_current_component_num(ComponentIndex index) {
+    if (index >= _num_components || index == _current_component_num)
+        return;
+
+    _previous_component_num = _current_component_num;
+    _current_component_num = index;
+    _p_current_component = _menu_components[_current_component_num];
+
+    _p_current_component->set_current();
+    _menu_components[_previous_component_num]->set_current(false);
+}
+
+MenuComponent const* Menu::get_menu_component(ComponentIndex index) const {
     return _menu_components[index];
 }
 
@@ -184,15 +446,15 @@ MenuComponent const* Menu::get_current_component() const {
     return _p_current_component;
 }
 
-uint8_t Menu::get_num_components() const {
+Menu::ComponentIndex Menu::get_num_components() const {
     return _num_components;
 }
 
-uint8_t Menu::get_current_component_num() const {
+Menu::ComponentIndex Menu::get_current_component_num() const {
     return _current_component_num;
 }
 
-uint8_t Menu::get_previous_component_num() const {
+Menu::ComponentIndex Menu::get_previous_component_num() const {
     return _previous_component_num;
 }
 
@@ -200,6 +462,12 @@ void Menu::render(MenuComponentRenderer const& renderer) const {
     renderer.render_menu(*this);
 }
 
+MenuComponent::Type Menu::get_type() const {
+    return TYPE_MENU;
+}
+
+#if MENUSYSTEM_BACK_ITEM
+
 // *********************************************************
 // BackMenuItem
 // *********************************************************
@@ -224,6 +492,12 @@ void BackMenuItem::render(MenuComponentRenderer const& renderer) const {
     renderer.render_back_menu_item(*this);
 }
 
+MenuComponent::Type BackMenuItem::get_type() const {
+    return TYPE_BACK_MENU_ITEM;
+}
+
+#endif
+
 // *********************************************************
 // MenuItem
 // *********************************************************
@@ -245,6 +519,10 @@ void MenuItem::render(MenuComponentRenderer const& renderer) const {
     renderer.render_menu_item(*this);
 }
 
+MenuComponent::Type MenuItem::get_type() const {
+    return TYPE_MENU_ITEM;
+}
+
 bool MenuItem::next(bool loop) {
     return false;
 }
@@ -253,6 +531,8 @@ bool MenuItem::prev(bool loop) {
     return false;
 }
 
+#if MENUSYSTEM_NUMERIC
+
 // *********************************************************
 // NumericMenuItem
 // *********************************************************
@@ -266,7 +546,13 @@ NumericMenuItem::NumericMenuItem(const char* basename, SelectFnPtr select_fn,
   _min_value(min_value),
   _max_value(max_value),
   _increment(increment),
-  _format_value_fn(format_value_fn) {
+  _format_value_fn(format_value_fn),
+  _value_change_fn(nullptr),
+  _value_change_interval(0),
+  _last_value_change(0),
+  _notified_value(value),
+  _snapshot_value(value),
+  _p_undo_history(nullptr) {
     if (_increment < 0.0) _increment = -_increment;
     if (_min_value > _max_value) {
         float tmp = _max_value;
@@ -279,19 +565,83 @@ void NumericMenuItem::set_number_formatter(FormatValueFnPtr format_value_fn) {
     _format_value_fn = format_value_fn;
 }
 
+void NumericMenuItem::set_value_change_function(ValueChangeFnPtr value_change_fn,
+                                                uint16_t interval) {
+    _value_change_fn = value_change_fn;
+    _value_change_interval = interval;
+    _last_value_change = millis() - interval;
+    _notified_value = _value;
+}
+
+void NumericMenuItem::set_undo_history(UndoHistory* p_undo_history) {
+    _p_undo_history = p_undo_history;
+}
+
 Menu* NumericMenuItem::select() {
     _has_focus = !_has_focus;
+    changed();
 
-    // Only run _select_fn when the user is done editing the value
-    if (!_has_focus && _select_fn != nullptr)
+    if (_has_focus) {
+        _snapshot_value = _value;
+        return nullptr;
+    }
+
+    // Only run _select_fn when the user is done editing the value; flush any
+    // coalesced change first so observers see the final value before commit.
+    notify_value_change(true);
+    if (_p_undo_history != nullptr && _value != _snapshot_value)
+        _p_undo_history->record(this, _snapshot_value, _value);
+    if (_select_fn != nullptr)
         _select_fn(this);
     return nullptr;
 }
 
+bool NumericMenuItem::back() {
+    if (!_has_focus)
+        return false;
+
+    _has_focus = false;
+    _value = _snapshot_value;
+    changed();
+    notify_value_change(true);
+    return true;
+}
+
+void NumericMenuItem::reset() {
+    back();
+}
+
+void NumericMenuItem::commit_value(float value) {
+    set_value(value);
+    if (_select_fn != nullptr)
+        _select_fn(this);
+}
+
+void NumericMenuItem::update() {
+    notify_value_change();
+}
+
+void NumericMenuItem::notify_value_change(bool force) {
+    if (_value_change_fn == nullptr || _value == _notified_value)
+        return;
+
+    uint32_t now = millis();
+    if (!force && now - _last_value_change < _value_change_interval)
+        return;
+
+    _last_value_change = now;
+    _notified_value = _value;
+    _value_change_fn(this);
+}
+
 void NumericMenuItem::render(MenuComponentRenderer const& renderer) const {
     renderer.render_numeric_menu_item(*this);
 }
 
+MenuComponent::Type NumericMenuItem::get_type() const {
+    return TYPE_NUMERIC_MENU_ITEM;
+}
+
 float NumericMenuItem::get_value() const {
     return _value;
 }
@@ -304,6 +654,10 @@ float NumericMenuItem::get_max_value() const {
     return _max_value;
 }
 
+float NumericMenuItem::get_increment() const {
+    return _increment;
+}
+
 String NumericMenuItem::get_formatted_value() const {
     String buffer;
     if (_format_value_fn != nullptr)
@@ -315,38 +669,261 @@ String NumericMenuItem::get_formatted_value() const {
 
 void NumericMenuItem::set_value(float value) {
     _value = value;
+    _notified_value = value;
+    changed();
 }
 
 void NumericMenuItem::set_min_value(float value) {
     _min_value = value;
+    changed();
 }
 
 void NumericMenuItem::set_max_value(float value) {
     _max_value = value;
+    changed();
 }
 
 bool NumericMenuItem::next(bool loop) {
+    float value = _value;
     _value += _increment;
     if (_value > _max_value) {
-        if (loop)
+        if (MENUSYSTEM_LOOP && loop)
             _value = _min_value;
         else
             _value = _max_value;
     }
+    if (_value != value)
+        changed();
+    notify_value_change();
     return true;
 }
 
 bool NumericMenuItem::prev(bool loop) {
+    float value = _value;
     _value -= _increment;
     if (_value < _min_value) {
-        if (loop)
+        if (MENUSYSTEM_LOOP && loop)
             _value = _max_value;
         else
             _value = _min_value;
     }
+    if (_value != value)
+        changed();
+    notify_value_change();
     return true;
 }
 
+// *********************************************************
+// ChoiceMenuItem
+// *********************************************************
+
+ChoiceMenuItem::ChoiceMenuItem(const char* name, SelectFnPtr select_fn,
+                               const char* const* labels, uint8_t num_choices,
+                               const int32_t* values, uint8_t index)
+: MenuItem(name, select_fn),
+  _labels(labels),
+  _values(values),
+  _num_choices(num_choices),
+  _index(index < num_choices ? index : 0),
+  _snapshot_index(_index) {
+}
+
+uint8_t ChoiceMenuItem::get_num_choices() const {
+    return _num_choices;
+}
+
+uint8_t ChoiceMenuItem::get_index() const {
+    return _index;
+}
+
+void ChoiceMenuItem::set_index(uint8_t index) {
+    if (index < _num_choices && index != _index) {
+        _index = index;
+        changed();
+    }
+}
+
+int32_t ChoiceMenuItem::get_value() const {
+    return get_value(_index);
+}
+
+int32_t ChoiceMenuItem::get_value(uint8_t index) const {
+    if (_values == nullptr)
+        return index;
+    return (int32_t) pgm_read_dword(&_values[index]);
+}
+
+bool ChoiceMenuItem::set_value(int32_t value) {
+    if (_values == nullptr) {
+        if (value < 0 || value >= _num_choices)
+            return false;
+        set_index(value);
+        return true;
+    }
+
+    uint8_t lo = 0;
+    uint8_t hi = _num_choices;
+    while (lo < hi) {
+        uint8_t mid = lo + (hi - lo) / 2;
+        int32_t mid_value = get_value(mid);
+        if (mid_value == value) {
+            set_index(mid);
+            return true;
+        }
+        if (mid_value < value)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return false;
+}
+
+const __FlashStringHelper* ChoiceMenuItem::get_label() const {
+    return get_label(_index);
+}
+
+const __FlashStringHelper* ChoiceMenuItem::get_label(uint8_t index) const {
+    return (const __FlashStringHelper*) pgm_read_ptr(&_labels[index]);
+}
+
+Menu* ChoiceMenuItem::select() {
+    _has_focus = !_has_focus;
+    changed();
+
+    if (_has_focus) {
+        _snapshot_index = _index;
+        return nullptr;
+    }
+
+    // Only run _select_fn when the user is done choosing
+    if (_select_fn != nullptr)
+        _select_fn(this);
+    return nullptr;
+}
+
+bool ChoiceMenuItem::back() {
+    if (!_has_focus)
+        return false;
+
+    _has_focus = false;
+    _index = _snapshot_index;
+    changed();
+    return true;
+}
+
+void ChoiceMenuItem::reset() {
+    back();
+}
+
+void ChoiceMenuItem::render(MenuComponentRenderer const& renderer) const {
+    renderer.render_choice_menu_item(*this);
+}
+
+MenuComponent::Type ChoiceMenuItem::get_type() const {
+    return TYPE_CHOICE_MENU_ITEM;
+}
+
+bool ChoiceMenuItem::next(bool loop) {
+    if (!_num_choices)
+        return false;
+
+    if (_index != _num_choices - 1)
+        set_index(_index + 1);
+    else if (MENUSYSTEM_LOOP && loop)
+        set_index(0);
+    return true;
+}
+
+bool ChoiceMenuItem::prev(bool loop) {
+    if (!_num_choices)
+        return false;
+
+    if (_index != 0)
+        set_index(_index - 1);
+    else if (MENUSYSTEM_LOOP && loop)
+        set_index(_num_choices - 1);
+    return true;
+}
+
+// *********************************************************
+// UndoHistory
+// *********************************************************
+
+UndoHistory::UndoHistory(Record* records, uint8_t capacity)
+: _records(records),
+  _capacity(capacity),
+  _head(0),
+  _num_undo(0),
+  _num_redo(0) {
+}
+
+bool UndoHistory::can_undo() const {
+    return _num_undo != 0;
+}
+
+bool UndoHistory::can_redo() const {
+    return _num_redo != 0;
+}
+
+bool UndoHistory::undo() {
+    if (!_num_undo)
+        return false;
+
+    _head = (_head ? _head : _capacity) - 1;
+    _num_undo--;
+    _num_redo++;
+
+    Record const& record = _records[_head];
+    record.p_item->commit_value(record.old_value);
+    return true;
+}
+
+bool UndoHistory::redo() {
+    if (!_num_redo)
+        return false;
+
+    Record const& record = _records[_head];
+    _head = (_head + 1 == _capacity) ? 0 : _head + 1;
+    _num_redo--;
+    _num_undo++;
+
+    record.p_item->commit_value(record.new_value);
+    return true;
+}
+
+void UndoHistory::clear() {
+    _head = 0;
+    _num_undo = 0;
+    _num_redo = 0;
+}
+
+void UndoHistory::record(NumericMenuItem* p_item, float old_value,
+                         float new_value) {
+    if (!_capacity)
+        return;
+
+    Record& record = _records[_head];
+    record.p_item = p_item;
+    record.old_value = old_value;
+    record.new_value = new_value;
+
+    _head = (_head + 1 == _capacity) ? 0 : _head + 1;
+    if (_num_undo < _capacity)
+        _num_undo++;
+    _num_redo = 0;
+}
+
+// *********************************************************
+// MenuComponentRenderer
+// *********************************************************
+
+void MenuComponentRenderer::render_choice_menu_item(
+        ChoiceMenuItem const& menu_item) const {
+    render_menu_item(menu_item);
+}
+
+#endif
+
 // *********************************************************
 // MenuSystem
 // *********************************************************
@@ -354,41 +931,82 @@ bool NumericMenuItem::prev(bool loop) {
 MenuSystem::MenuSystem(MenuComponentRenderer const& renderer)
 : _p_root_menu(new Menu("", nullptr)),
   _p_curr_menu(_p_root_menu),
-  _renderer(renderer) {
+  _renderer(renderer),
+  _depth(0)
+#if MENUSYSTEM_INSTRUMENTATION
+  , _displayed_generation(MenuComponent::_generation - 1),
+  _idle_timeout(0),
+  _last_input_time(0),
+  _idle_fn(nullptr),
+  _is_idle(false)
+#endif
+{
 }
 
 bool MenuSystem::next(bool loop) {
+    on_input();
+#if MENUSYSTEM_NUMERIC
     if (_p_curr_menu->_p_current_component->has_focus())
         return _p_curr_menu->_p_current_component->next(loop);
-    else
-        return _p_curr_menu->next(loop);
+#endif
+    return _p_curr_menu->next(loop);
 }
 
 bool MenuSystem::prev(bool loop) {
+    on_input();
+#if MENUSYSTEM_NUMERIC
     if (_p_curr_menu->_p_current_component->has_focus())
         return _p_curr_menu->_p_current_component->prev(loop);
-    else
-        return _p_curr_menu->prev(loop);
+#endif
+    return _p_curr_menu->prev(loop);
 }
 
 void MenuSystem::reset() {
+    on_input();
     _p_curr_menu = _p_root_menu;
+    _depth = 0;
     _p_root_menu->reset();
+    MenuComponent::changed();
 }
 
 void MenuSystem::select(bool reset) {
+    on_input();
+
+    // Don't enter menus nested deeper than the stack can remember, nor call
+    // their select functions
+    MenuComponent const* p_component = _p_curr_menu->get_current_component();
+    if (_depth == MENUSYSTEM_MAX_DEPTH && p_component != nullptr
+            && p_component->get_type() == MenuComponent::TYPE_MENU)
+        return;
+
     Menu* pMenu = _p_curr_menu->activate();
 
-    if (pMenu != nullptr)
+    // Select functions may draw over the menu, so always render again
+    MenuComponent::changed();
+
+    if (pMenu != nullptr) {
+        NavigationFrame& frame = _navigation_stack[_depth++];
+        frame.p_menu = _p_curr_menu;
+        frame.component_num = _p_curr_menu->get_current_component_num();
         _p_curr_menu = pMenu;
-    else
-        if (reset)
-            this->reset();
+    } else if (reset) {
+        this->reset();
+    }
 }
 
 bool MenuSystem::back() {
-    if (_p_curr_menu != _p_root_menu) {
-        _p_curr_menu = const_cast<Menu*>(_p_curr_menu->get_parent());
+    on_input();
+#if MENUSYSTEM_NUMERIC
+    MenuComponent* p_component = _p_curr_menu->_p_current_component;
+    if (p_component != nullptr && p_component->has_focus())
+        return p_component->back();
+#endif
+
+    if (_depth != 0) {
+        NavigationFrame const& frame = _navigation_stack[--_depth];
+        _p_curr_menu = frame.p_menu;
+        _p_curr_menu->set_current_component_num(frame.component_num);
+        MenuComponent::changed();
         return true;
     }
 
@@ -396,6 +1014,47 @@ bool MenuSystem::back() {
     return false;
 }
 
+void MenuSystem::update() {
+#if MENUSYSTEM_NUMERIC
+    MenuComponent* p_component = _p_curr_menu->_p_current_component;
+    if (p_component != nullptr)
+        p_component->update();
+#endif
+
+#if MENUSYSTEM_INSTRUMENTATION
+    if (_idle_timeout && !_is_idle
+            && millis() - _last_input_time >= _idle_timeout) {
+        if (_idle_fn != nullptr)
+            _idle_fn(*this);
+        else
+            reset();
+        _is_idle = true;
+    }
+#endif
+}
+
+#if MENUSYSTEM_INSTRUMENTATION
+void MenuSystem::set_idle_timeout(uint32_t timeout, IdleFnPtr idle_fn) {
+    _idle_timeout = timeout;
+    _idle_fn = idle_fn;
+    _last_input_time = millis();
+}
+
+bool MenuSystem::is_idle() const {
+    return _is_idle;
+}
+#endif
+
+void MenuSystem::on_input() {
+#if MENUSYSTEM_INSTRUMENTATION
+    _last_input_time = millis();
+    if (_is_idle) {
+        _is_idle = false;
+        invalidate();
+    }
+#endif
+}
+
 Menu& MenuSystem::get_root_menu() const {
     return *_p_root_menu;
 }
@@ -404,7 +1063,38 @@ Menu const* MenuSystem::get_current_menu() const {
     return _p_curr_menu;
 }
 
+uint8_t MenuSystem::get_depth() const {
+    return _depth;
+}
+
+Menu const* MenuSystem::get_menu(uint8_t depth) const {
+    if (depth == _depth)
+        return _p_curr_menu;
+    return _navigation_stack[depth].p_menu;
+}
+
+Menu::ComponentIndex MenuSystem::get_entry_component_num(uint8_t depth) const {
+    return _navigation_stack[depth].component_num;
+}
+
+void MenuSystem::invalidate() {
+    MenuComponent::changed();
+}
+
+#if MENUSYSTEM_INSTRUMENTATION
+uint16_t MenuSystem::get_generation() const {
+    return MenuComponent::_generation;
+}
+#endif
+
 void MenuSystem::display() const {
-    if (_p_curr_menu != nullptr)
-        _renderer.render(*_p_curr_menu);
+    if (_p_curr_menu == nullptr)
+        return;
+
+#if MENUSYSTEM_INSTRUMENTATION
+    if (_displayed_generation == MenuComponent::_generation)
+        return;
+    _displayed_generation = MenuComponent::_generation;
+#endif
+    _renderer.render(*_p_curr_menu);
 }
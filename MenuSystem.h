@@ -12,9 +12,62 @@
   #include <WProgram.h>
 #endif
 
+//! \brief The integer type used to index the components of a Menu
+//!
+//! It bounds the number of components a single Menu can hold: 255 with the
+//! default uint8_t on AVR, 65535 with the default uint16_t elsewhere. Define
+//! it in the build flags (e.g. `-DMENUSYSTEM_COMPONENT_INDEX_TYPE=uint32_t`)
+//! to override the default.
+#ifndef MENUSYSTEM_COMPONENT_INDEX_TYPE
+  #if defined(__AVR__)
+    #define MENUSYSTEM_COMPONENT_INDEX_TYPE uint8_t
+  #else
+    #define MENUSYSTEM_COMPONENT_INDEX_TYPE uint16_t
+  #endif
+#endif
+
+//! \brief The maximum depth of nested menus MenuSystem can enter
+//!
+//! It sizes MenuSystem's navigation stack. Define it in the build flags to
+//! override the default.
+#ifndef MENUSYSTEM_MAX_DEPTH
+  #define MENUSYSTEM_MAX_DEPTH 8
+#endif
+
+//! \brief Compile time feature selection
+//!
+//! Every feature is enabled by default. Define a feature as 0 in the build
+//! flags (e.g. `-DMENUSYSTEM_NUMERIC=0` in PlatformIO's `build_flags` or the
+//! examples' `CXXFLAGS`) to compile its code and data out of the library.
+//! Renderers must then drop the methods for the removed component types.
+//!
+//! - MENUSYSTEM_NUMERIC: NumericMenuItem, ChoiceMenuItem, UndoHistory and
+//!   component focus.
+//! - MENUSYSTEM_BACK_ITEM: BackMenuItem.
+//! - MENUSYSTEM_LOOP: looping in next and prev; the `loop` arguments are
+//!   ignored when disabled.
+//! - MENUSYSTEM_INSTRUMENTATION: the generation counter that lets
+//!   MenuSystem::display skip redundant renders, and the idle timeout.
+#ifndef MENUSYSTEM_NUMERIC
+  #define MENUSYSTEM_NUMERIC 1
+#endif
+#ifndef MENUSYSTEM_BACK_ITEM
+  #define MENUSYSTEM_BACK_ITEM 1
+#endif
+#ifndef MENUSYSTEM_LOOP
+  #define MENUSYSTEM_LOOP 1
+#endif
+#ifndef MENUSYSTEM_INSTRUMENTATION
+  #define MENUSYSTEM_INSTRUMENTATION 1
+#endif
+
+class BackMenuItem;
+class ChoiceMenuItem;
 class Menu;
 class MenuComponentRenderer;
 class MenuSystem;
+class NumericMenuItem;
+class UndoHistory;
 
 //! \brief Abstract base class that represents a component in the menu
 //!
@@ -38,6 +91,17 @@ public:
     //! \param menu_component The menu component being selected.
     using SelectFnPtr = void (*)(MenuComponent* menu_component);
 
+    //! \brief The library class a component is or derives from
+    //!
+    //! \see MenuComponent::get_type
+    enum Type : uint8_t {
+        TYPE_MENU_ITEM,
+        TYPE_BACK_MENU_ITEM,
+        TYPE_NUMERIC_MENU_ITEM,
+        TYPE_CHOICE_MENU_ITEM,
+        TYPE_MENU
+    };
+
 public:
     //! \brief Construct a MenuComponent
     //! \param[in] name The name of the menu component that is displayed in
@@ -45,6 +109,10 @@ public:
     MenuComponent(const char* name, SelectFnPtr select_fn);
 
     //! \brief Set the component's name
+    //!
+    //! Call it again after rewriting the name in place, so clients caching
+    //! the name (e.g. NameBitmapCache) notice the change.
+    //!
     //! \param[in] name The name of the menu component that is displayed in
     //!                 clients.
     void set_name(const char* name);
@@ -53,6 +121,11 @@ public:
     //! \returns The component's name.
     const char* get_name() const;
 
+    //! \brief Returns a counter that changes with every call to set_name
+    //!
+    //! It wraps around after 256 calls.
+    uint8_t get_name_version() const;
+
     //! \brief Renders the component using the given MenuComponentRenderer
     //!
     //! This is the `accept` method in the visitor design pattern. It should
@@ -66,6 +139,14 @@ public:
     //! \see MenuComponentRenderer
     virtual void render(MenuComponentRenderer const& renderer) const = 0;
 
+    //! \brief Returns the library class this component is or derives from
+    //!
+    //! Lets tools such as MenuStreamWriter tell components apart without
+    //! rendering them, since a custom component may only render with its own
+    //! MenuComponentRenderer. A component derived from a library class keeps
+    //! the type of that class.
+    virtual Type get_type() const = 0;
+
     //! \brief Returns true if this component has focus; false otherwise
     //!
     //! A component has focus when the next and prev functions are able to
@@ -162,6 +243,32 @@ protected:
     //! \see NumericMenuComponent
     virtual Menu* select();
 
+#if MENUSYSTEM_NUMERIC
+    //! \brief Processes the back action
+    //!
+    //! Called from MenuSystem::back when the component has focus. Components
+    //! that support focus should discard the changes made since they gained
+    //! focus, restore their previous state and release focus.
+    //!
+    //! The default implementation does nothing.
+    //!
+    //! \returns true if the component processed the action, false otherwise.
+    //!
+    //! \see MenuComponent::has_focus
+    virtual bool back();
+
+    //! \brief Processes time based work
+    //!
+    //! Called from MenuSystem::update on the current component of the current
+    //! menu. Components that defer work, such as NumericMenuItem coalescing
+    //! value change notifications, perform it here.
+    //!
+    //! The default implementation does nothing.
+    //!
+    //! \see MenuSystem::update
+    virtual void update();
+#endif
+
     //! \brief Set the current state of the component
     //!
     //! \paran is_current true if this component is the current one; false
@@ -169,11 +276,31 @@ protected:
     //! \see is_current
     void set_current(bool is_current=true);
 
+    //! \brief Records that the state of a component changed
+    //!
+    //! Subclasses must call this whenever a change affects what's rendered,
+    //! so MenuSystem::display knows the menu needs rendering again.
+    //!
+    //! \see MenuSystem::get_generation
+#if MENUSYSTEM_INSTRUMENTATION
+    static void changed();
+#else
+    static void changed() {}
+#endif
+
 protected:
     const char* _name;
+#if MENUSYSTEM_NUMERIC
     bool _has_focus;
+#endif
     bool _is_current;
+    uint8_t _name_version;
     SelectFnPtr _select_fn;
+
+#if MENUSYSTEM_INSTRUMENTATION
+private:
+    static uint16_t _generation;
+#endif
 };
 
 
@@ -197,6 +324,9 @@ public:
     //! \copydoc MenuComponent::render
     virtual void render(MenuComponentRenderer const& renderer) const;
 
+    //! \copydoc MenuComponent::get_type
+    virtual Type get_type() const;
+
 protected:
     //! \copydoc MenuComponent::next
     //!
@@ -218,6 +348,7 @@ protected:
 };
 
 
+#if MENUSYSTEM_BACK_ITEM
 //! \brief A MenuItem that calls MenuSystem::back() when selected.
 //! \see MenuItem
 class BackMenuItem : public MenuItem {
@@ -225,6 +356,7 @@ public:
     BackMenuItem(const char* name, SelectFnPtr select_fn, MenuSystem* ms);
 
     virtual void render(MenuComponentRenderer const& renderer) const;
+    virtual Type get_type() const;
 
 protected:
     virtual Menu* select();
@@ -232,8 +364,10 @@ protected:
 protected:
     MenuSystem* _menu_system;
 };
+#endif
 
 
+#if MENUSYSTEM_NUMERIC
 class NumericMenuItem : public MenuItem {
 public:
     //! \brief Callback for formatting the numeric value into a String.
@@ -242,6 +376,12 @@ public:
     //! \returns The String representation of value.
     using FormatValueFnPtr = const String (*)(const float value);
 
+    //! \brief Callback for when the value changes while it's being edited
+    //!
+    //! \param menu_item The numeric menu item whose value changed. Use
+    //!                  NumericMenuItem::get_value to read the latest value.
+    using ValueChangeFnPtr = void (*)(NumericMenuItem* menu_item);
+
 public:
     //! Constructor
     //!
@@ -266,9 +406,38 @@ public:
     //!
     void set_number_formatter(FormatValueFnPtr format_value_fn);
 
+    //! \brief Sets the function to call when the value changes during editing
+    //!
+    //! The function is called with the latest value while the item has focus,
+    //! so clients can preview the value (e.g. display contrast) without
+    //! polling. Changes are coalesced: the function is called at most once
+    //! every `interval` milliseconds and a change made within the interval is
+    //! delivered by MenuSystem::update once it has elapsed. Any pending change
+    //! is delivered before the select function, which acts as the commit
+    //! callback when editing ends.
+    //!
+    //! Values set with NumericMenuItem::set_value are not reported. Values
+    //! restored by cancelling an edit are, so previews can be reverted.
+    //!
+    //! \param[in] value_change_fn The function to call; nullptr disables
+    //!                            notifications.
+    //! \param[in] interval The minimum time in milliseconds between calls.
+    void set_value_change_function(ValueChangeFnPtr value_change_fn,
+                                   uint16_t interval=0);
+
+    //! \brief Sets the history committed edits are recorded in
+    //!
+    //! Several items can share one history so edits can be undone and redone
+    //! across items.
+    //!
+    //! \param[in] p_undo_history The history to record in; nullptr disables
+    //!                           recording.
+    void set_undo_history(UndoHistory* p_undo_history);
+
     float get_value() const;
     float get_min_value() const;
     float get_max_value() const;
+    float get_increment() const;
 
     void set_value(float value);
     void set_min_value(float value);
@@ -277,20 +446,206 @@ public:
     String get_formatted_value() const;
 
     virtual void render(MenuComponentRenderer const& renderer) const;
+    virtual Type get_type() const;
 
 protected:
     virtual bool next(bool loop=false);
     virtual bool prev(bool loop=false);
 
+    //! \copydoc MenuComponent::select
+    //!
+    //! Gaining focus starts an edit and snapshots the value. Releasing focus
+    //! commits the edit: it's recorded in the undo history and the select
+    //! function is called.
     virtual Menu* select();
 
+    //! \copydoc MenuComponent::back
+    //!
+    //! Cancels the edit, restoring the value snapshot taken by select.
+    virtual bool back();
+
+    //! \copydoc MenuComponent::reset
+    //!
+    //! Cancels an open edit like NumericMenuItem::back.
+    virtual void reset();
+
+    //! \copydoc MenuComponent::update
+    //!
+    //! Delivers a coalesced value change once the interval has elapsed.
+    virtual void update();
+
+    //! \brief Calls the value change function if the value has changed
+    //!
+    //! \param[in] force if true the interval is ignored.
+    void notify_value_change(bool force=false);
+
+    //! \brief Applies a value outside of an edit and calls the select function
+    //!
+    //! Used by UndoHistory to undo and redo committed edits.
+    void commit_value(float value);
+
+    friend class UndoHistory;
+
 protected:
     float _value;
     float _min_value;
     float _max_value;
     float _increment;
     FormatValueFnPtr _format_value_fn;
+    ValueChangeFnPtr _value_change_fn;
+    uint16_t _value_change_interval;
+    uint32_t _last_value_change;
+    float _notified_value;
+    float _snapshot_value;
+    UndoHistory* _p_undo_history;
+};
+
+
+//! \brief A bounded history of committed NumericMenuItem edits
+//!
+//! The history is a ring buffer over storage supplied by the client, so it
+//! uses a fixed amount of RAM; once full, recording an edit discards the
+//! oldest one. Recording a new edit discards anything that could be redone.
+//!
+//! Undoing or redoing an edit sets the item's value and calls its select
+//! function, the same callback that applies a committed edit.
+//!
+//! \code
+//! UndoHistory::Record undo_records[8];
+//! UndoHistory undo_history(undo_records, 8);
+//! \endcode
+//!
+//! \see NumericMenuItem::set_undo_history
+class UndoHistory {
+    friend class NumericMenuItem;
+public:
+    //! \brief A committed edit
+    struct Record {
+        NumericMenuItem* p_item;
+        float old_value;
+        float new_value;
+    };
+
+public:
+    //! \brief Construct an UndoHistory
+    //! \param[in] records Storage for the history.
+    //! \param[in] capacity The number of elements in records.
+    UndoHistory(Record* records, uint8_t capacity);
+
+    bool can_undo() const;
+    bool can_redo() const;
+
+    //! \brief Reverts the most recent edit
+    //! \returns true if an edit was undone, false if there was none.
+    bool undo();
+
+    //! \brief Reapplies the most recently undone edit
+    //! \returns true if an edit was redone, false if there was none.
+    bool redo();
+
+    //! \brief Discards all recorded edits
+    void clear();
+
+protected:
+    void record(NumericMenuItem* p_item, float old_value, float new_value);
+
+private:
+    Record* _records;
+    uint8_t _capacity;
+    uint8_t _head;
+    uint8_t _num_undo;
+    uint8_t _num_redo;
+};
+
+
+//! \brief A MenuItem that chooses one value from a fixed list.
+//!
+//! The labels, and optionally the values, are tables stored in flash
+//! (PROGMEM), so rendering the current label needs no allocation. When the
+//! item is selected it gains focus and MenuComponent::next and
+//! MenuComponent::prev step through the choices, looping or clamping like
+//! Menu does. Selecting it again releases focus and calls the select
+//! function.
+//!
+//! \see MenuItem
+class ChoiceMenuItem : public MenuItem {
+public:
+    //! \brief Construct a ChoiceMenuItem
+    //!
+    //! \param[in] name The name of the menu item.
+    //! \param[in] select_fn The function to call when editing ends.
+    //! \param[in] labels PROGMEM table of PROGMEM strings, one per choice.
+    //! \param[in] num_choices The number of entries in labels.
+    //! \param[in] values Optional PROGMEM table of values, one per choice,
+    //!                   sorted in ascending order. If nullptr the value of a
+    //!                   choice is its index.
+    //! \param[in] index The initially selected choice.
+    ChoiceMenuItem(const char* name, SelectFnPtr select_fn,
+                   const char* const* labels, uint8_t num_choices,
+                   const int32_t* values=nullptr, uint8_t index=0);
+
+    uint8_t get_num_choices() const;
+    uint8_t get_index() const;
+
+    //! \brief Sets the selected choice; out of range indices are ignored
+    void set_index(uint8_t index);
+
+    //! \brief Returns the value of the selected choice
+    int32_t get_value() const;
+
+    //! \brief Returns the value of the choice at index
+    int32_t get_value(uint8_t index) const;
+
+    //! \brief Selects the choice with the given value
+    //!
+    //! Uses a binary search over the value table, or the value directly as
+    //! the index when there is no value table.
+    //!
+    //! \returns true if a choice with the value exists, false otherwise.
+    bool set_value(int32_t value);
+
+    //! \brief Returns the label of the selected choice
+    //!
+    //! The label lives in flash and can be printed directly.
+    const __FlashStringHelper* get_label() const;
+
+    //! \brief Returns the label of the choice at index
+    const __FlashStringHelper* get_label(uint8_t index) const;
+
+    //! \copydoc MenuComponent::render
+    virtual void render(MenuComponentRenderer const& renderer) const;
+
+    //! \copydoc MenuComponent::get_type
+    virtual Type get_type() const;
+
+protected:
+    //! \copydoc MenuComponent::next
+    virtual bool next(bool loop=false);
+
+    //! \copydoc MenuComponent::prev
+    virtual bool prev(bool loop=false);
+
+    //! \copydoc MenuComponent::select
+    virtual Menu* select();
+
+    //! \copydoc MenuComponent::back
+    //!
+    //! Restores the choice selected when the item gained focus.
+    virtual bool back();
+
+    //! \copydoc MenuComponent::reset
+    //!
+    //! Cancels an open edit like ChoiceMenuItem::back.
+    virtual void reset();
+
+protected:
+    const char* const* _labels;
+    const int32_t* _values;
+    uint8_t _num_choices;
+    uint8_t _index;
+    uint8_t _snapshot_index;
 };
+#endif
 
 
 //! \brief A MenuComponent that can contain other MenuComponents.
@@ -303,29 +658,129 @@ protected:
 //! \see MenuItem
 class Menu : public MenuComponent {
     friend class MenuSystem;
+    friend class MenuBlobLoader;
+public:
+    //! \brief The index type of the menu's components
+    //! \see MENUSYSTEM_COMPONENT_INDEX_TYPE
+    using ComponentIndex = MENUSYSTEM_COMPONENT_INDEX_TYPE;
+
 public:
     Menu(const char* name, SelectFnPtr select_fn=nullptr);
 
     //! \brief Adds a MenuItem to the Menu
+    //!
+    //! The item is not added if the menu already holds the maximum number of
+    //! components ComponentIndex can index or if memory runs out.
     void add_item(MenuItem* p_item);
 
     //! \brief Adds a Menu to the Menu
+    //!
+    //! The same Menu can be added to several menus; MenuSystem tracks how it
+    //! was entered so MenuSystem::back returns to the right parent.
+    //!
+    //! MenuSystem enters at most MENUSYSTEM_MAX_DEPTH nested menus; selecting
+    //! a menu below that depth does nothing and doesn't call its select
+    //! function.
+    //!
+    //! \see Menu::add_item
     void add_menu(Menu* p_menu);
 
+    //! \brief Reserves storage for the given number of components
+    //!
+    //! Storage otherwise grows geometrically as components are added. Menus
+    //! generated with a known size can call this first so they use exactly
+    //! the memory they need.
+    //!
+    //! \returns true if the storage is available, false otherwise.
+    bool reserve(ComponentIndex num_components);
+
     MenuComponent const* get_current_component() const;
-    MenuComponent const* get_menu_component(uint8_t index) const;
+    MenuComponent const* get_menu_component(ComponentIndex index) const;
+
+    ComponentIndex get_num_components() const;
+    ComponentIndex get_current_component_num() const;
+    ComponentIndex get_previous_component_num() const;
+
+    //! \brief Shows or hides the component at index
+    //!
+    //! Hidden components are skipped by MenuComponent::next and
+    //! MenuComponent::prev. Hiding the current component moves the cursor to
+    //! the nearest visible one. Components are visible when added; when the
+    //! current component is hidden, showing or adding one moves the cursor
+    //! there.
+    void set_component_visible(ComponentIndex index, bool visible=true);
+    bool is_component_visible(ComponentIndex index) const;
+
+    //! \brief Enables or disables the component at index
+    //!
+    //! Disabled components can be navigated to but not selected. Components
+    //! are enabled when added.
+    void set_component_enabled(ComponentIndex index, bool enabled=true);
+    bool is_component_enabled(ComponentIndex index) const;
+
+    //! \brief Returns the flags generation of the last time a component of
+    //!        this menu was shown, hidden, enabled or disabled
+    //!
+    //! Lets clients such as MenuStreamWriter notice changed flags without
+    //! comparing them all. 0 if the flags never changed.
+    //!
+    //! \see get_last_flags_generation
+    uint16_t get_flags_generation() const;
+
+    //! \brief Returns the flags generation of the last change to the flags
+    //!        of any menu
+    //!
+    //! Increases by one with every change, wrapping around after 65536.
+    static uint16_t get_last_flags_generation();
 
-    uint8_t get_num_components() const;
-    uint8_t get_current_component_num() const;
-    uint8_t get_previous_component_num() const;
+    //! \brief Returns the number of visible components
+    ComponentIndex get_num_visible_components() const;
+
+    //! \brief Returns the visible component at the given visible position
+    //!
+    //! Counts the visible components of every mask word before it, so use
+    //! Menu::get_next_visible_component_num to iterate over all of them.
+    //!
+    //! \param[in] visible_index A position less than
+    //!                          Menu::get_num_visible_components.
+    MenuComponent const* get_visible_component(ComponentIndex visible_index) const;
+
+    //! \brief Finds the first visible component at or after from
+    //!
+    //! Renderers can iterate over the visible components in a single pass:
+    //!
+    //!     Menu::ComponentIndex i;
+    //!     for (bool found = menu.get_next_visible_component_num(0, i); found;
+    //!             found = menu.get_next_visible_component_num(i + 1, i))
+    //!         menu.get_menu_component(i)->render(renderer);
+    //!
+    //! \param[in] from The component number to start from. May be
+    //!                 Menu::get_num_components.
+    //! \param[out] index The component number found.
+    //! \returns false if no component at or after from is visible.
+    bool get_next_visible_component_num(size_t from, ComponentIndex& index) const;
+
+    //! \brief Returns the visible position of the current component
+    ComponentIndex get_current_visible_component_num() const;
 
     //! \copydoc MenuComponent::render
     void render(MenuComponentRenderer const& renderer) const;
 
+    //! \copydoc MenuComponent::get_type
+    Type get_type() const;
+
 protected:
     void set_parent(Menu* p_parent);
+
+    //! \brief Returns the menu this menu was last added to
+    //!
+    //! MenuSystem doesn't use it: a shared menu has several parents. Use
+    //! MenuSystem::get_menu to find how the current menu was entered.
     Menu const* get_parent() const;
 
+    //! \brief Makes the component at index the current component
+    void set_current_component_num(ComponentIndex index);
+
     //! \brief Activates the current selection
     //!
     //! When a client makes a selection, activate is called on the current menu
@@ -346,34 +801,170 @@ protected:
 
     void add_component(MenuComponent* p_component);
 
+private:
+    //! \brief A word of the visibility and enabled bitmasks
+    using MaskWord = unsigned int;
+
+    static const uint8_t MASK_WORD_BITS = sizeof(MaskWord) * 8;
+
+    static size_t get_num_mask_words(size_t num_components);
+
+    static bool get_mask_bit(MaskWord const* mask, ComponentIndex index);
+    static void set_mask_bit(MaskWord* mask, ComponentIndex index, bool value);
+
+    //! \brief Finds the first visible component at or after from
+    bool find_next_visible(size_t from, ComponentIndex& index) const;
+
+    //! \brief Finds the last visible component at or before from
+    bool find_prev_visible(size_t from, ComponentIndex& index) const;
+
+    //! \brief Frees the component list and masks, leaving the menu empty
+    //!
+    //! Lets MenuBlobLoader undo a failed load.
+    void release();
+
 private:
     MenuComponent* _p_current_component;
     MenuComponent** _menu_components;
+    MaskWord* _visible_mask;
+    MaskWord* _enabled_mask;
     Menu* _p_parent;
-    uint8_t _num_components;
-    uint8_t _current_component_num;
-    uint8_t _previous_component_num;
+    ComponentIndex _num_components;
+    ComponentIndex _num_visible_components;
+    ComponentIndex _capacity;
+    ComponentIndex _current_component_num;
+    ComponentIndex _previous_component_num;
+    uint16_t _flags_generation;
+
+    static uint16_t _last_flags_generation;
 };
 
 
+//! \brief The root of the menu structure and the interface to clients
+//!
+//! MenuSystem keeps a bounded navigation stack of the menus entered to reach
+//! the current menu, so a Menu can be shared by several parents and
+//! renderers can show breadcrumbs in O(depth).
 class MenuSystem {
+public:
+    //! \brief Callback for when the menu system becomes idle
+    //!
+    //! \param menu_system The idle menu system.
+    using IdleFnPtr = void (*)(MenuSystem& menu_system);
+
 public:
     MenuSystem(MenuComponentRenderer const& renderer);
 
+    //! \brief Renders the current menu if it changed since it was last
+    //!        rendered
+    //!
+    //! Calling it when nothing changed does nothing, so it's cheap to call
+    //! every loop.
+    //!
+    //! \see MenuSystem::invalidate
     void display() const;
+
+    //! \brief Forces the next call to MenuSystem::display to render
+    //!
+    //! Use it after drawing over the menu, e.g. from a select function.
+    void invalidate();
+
+#if MENUSYSTEM_INSTRUMENTATION
+    //! \brief Returns a counter that increases on every state change
+    //!
+    //! Two equal generations mean nothing that affects rendering changed in
+    //! between.
+    uint16_t get_generation() const;
+#endif
+
     bool next(bool loop=false);
     bool prev(bool loop=false);
     void reset();
     void select(bool reset=false);
+    //! \brief Goes back
+    //!
+    //! If the current component has focus, its edit is cancelled and its
+    //! previous state restored. Otherwise the menu the current menu was
+    //! entered from becomes the current menu, with the component used to
+    //! enter it current again.
+    //!
+    //! \returns true if the action was processed, false otherwise.
     bool back();
 
+    //! \brief Performs deferred and time based work
+    //!
+    //! Should be called regularly, typically from `loop()`. It delivers
+    //! coalesced notifications such as those set with
+    //! NumericMenuItem::set_value_change_function, and detects when the menu
+    //! system becomes idle.
+    void update();
+
+#if MENUSYSTEM_INSTRUMENTATION
+    //! \brief Sets the idle timeout
+    //!
+    //! The menu system becomes idle when no input (next, prev, select, back
+    //! or reset) is received for `timeout` milliseconds. When that happens
+    //! MenuSystem::update calls `idle_fn`, which can show a screensaver or
+    //! put the MCU to sleep; if it's nullptr the menu system is reset to the
+    //! root menu instead, cancelling any open edit. The next input wakes the
+    //! menu system up and forces it to be rendered again.
+    //!
+    //! \param[in] timeout The timeout in milliseconds; 0 disables it.
+    //! \param[in] idle_fn The function to call when the timeout expires.
+    void set_idle_timeout(uint32_t timeout, IdleFnPtr idle_fn=nullptr);
+
+    //! \brief Returns true if the idle timeout expired; false otherwise
+    bool is_idle() const;
+#endif
+
     Menu& get_root_menu() const;
     Menu const* get_current_menu() const;
 
+    //! \brief Returns the number of menus entered from the root menu
+    //!
+    //! 0 when the current menu is the root menu.
+    uint8_t get_depth() const;
+
+    //! \brief Returns the menu at the given depth of the navigation stack
+    //!
+    //! Depth 0 is the root menu and MenuSystem::get_depth the current menu,
+    //! so iterating over them yields the breadcrumb path.
+    //!
+    //! \param[in] depth A depth up to and including MenuSystem::get_depth.
+    Menu const* get_menu(uint8_t depth) const;
+
+    //! \brief Returns the number of the component entered from the menu at
+    //!        the given depth
+    //!
+    //! Identifies which entry point led to the current menu when it's shared.
+    //!
+    //! \param[in] depth A depth less than MenuSystem::get_depth.
+    Menu::ComponentIndex get_entry_component_num(uint8_t depth) const;
+
+private:
+    //! \brief A menu that was entered from, and how
+    struct NavigationFrame {
+        Menu* p_menu;
+        Menu::ComponentIndex component_num;
+    };
+
+private:
+    //! \brief Records user input, waking the menu system if it's idle
+    void on_input();
+
 private:
     Menu* _p_root_menu;
     Menu* _p_curr_menu;
     MenuComponentRenderer const& _renderer;
+    NavigationFrame _navigation_stack[MENUSYSTEM_MAX_DEPTH];
+    uint8_t _depth;
+#if MENUSYSTEM_INSTRUMENTATION
+    mutable uint16_t _displayed_generation;
+    uint32_t _idle_timeout;
+    uint32_t _last_input_time;
+    IdleFnPtr _idle_fn;
+    bool _is_idle;
+#endif
 };
 
 
@@ -382,9 +973,20 @@ public:
     virtual void render(Menu const& menu) const = 0;
 
     virtual void render_menu_item(MenuItem const& menu_item) const = 0;
+#if MENUSYSTEM_BACK_ITEM
     virtual void render_back_menu_item(BackMenuItem const& menu_item) const = 0;
+#endif
+#if MENUSYSTEM_NUMERIC
     virtual void render_numeric_menu_item(NumericMenuItem const& menu_item) const = 0;
+#endif
     virtual void render_menu(Menu const& menu) const = 0;
+
+#if MENUSYSTEM_NUMERIC
+    //! \brief Renders a ChoiceMenuItem
+    //!
+    //! The default implementation renders it as a plain MenuItem.
+    virtual void render_choice_menu_item(ChoiceMenuItem const& menu_item) const;
+#endif
 };
 
 
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include "NameBitmapCache.h"
+#include <string.h>
+
+NameBitmapCache::NameBitmapCache(Entry* entries, uint8_t num_entries,
+                                 uint8_t* columns, uint16_t max_width)
+: _entries(entries),
+  _num_entries(num_entries),
+  _columns(columns),
+  _max_width(max_width),
+  _tick(0) {
+    clear();
+}
+
+NameBitmapCache::Strip NameBitmapCache::get(MenuComponent const& component,
+                                            Font const& font) {
+    uint16_t tick = ++_tick;
+
+    // Look the strip up while tracking the least recently used slot, so a
+    // miss needs no second pass. Empty slots are the oldest of all.
+    uint8_t victim_num = 0;
+    uint16_t victim_age = 0;
+    for (uint8_t i = 0; i < _num_entries; ++i) {
+        Entry& entry = _entries[i];
+        if (entry.p_component == &component && entry.p_font == &font) {
+            // set_name may rewrite the same string, so the pointer alone
+            // can't tell the name changed
+            if (entry.name != component.get_name()
+                    || entry.name_version != component.get_name_version()) {
+                entry.name = component.get_name();
+                entry.name_version = component.get_name_version();
+                rasterize(entry, get_columns(i));
+            }
+            entry.last_used = tick;
+            return Strip { get_columns(i), entry.width };
+        }
+
+        uint16_t age = entry.p_component ? tick - entry.last_used : 0xFFFF;
+        if (i == 0 || age > victim_age) {
+            victim_num = i;
+            victim_age = age;
+        }
+    }
+
+    if (!_num_entries)
+        return Strip { nullptr, 0 };
+
+    Entry& entry = _entries[victim_num];
+    entry.p_component = &component;
+    entry.p_font = &font;
+    entry.name = component.get_name();
+    entry.name_version = component.get_name_version();
+    entry.last_used = tick;
+    rasterize(entry, get_columns(victim_num));
+    return Strip { get_columns(victim_num), entry.width };
+}
+
+void NameBitmapCache::clear() {
+    for (uint8_t i = 0; i < _num_entries; ++i) {
+        _entries[i].p_component = nullptr;
+        _entries[i].p_font = nullptr;
+        _entries[i].name = nullptr;
+        _entries[i].name_version = 0;
+        _entries[i].width = 0;
+        _entries[i].last_used = 0;
+    }
+}
+
+void NameBitmapCache::blit(Strip const& strip, uint8_t* frame,
+                           uint16_t frame_width, uint8_t frame_pages,
+                           int16_t x, int16_t y) {
+    int16_t first = x < 0 ? -x : 0;
+    int16_t last = strip.width;
+    if (x + last > (int16_t) frame_width)
+        last = frame_width - x;
+    if (first >= last || y <= -8 || y >= frame_pages * 8)
+        return;
+
+    uint8_t const* src = strip.columns + first;
+    uint16_t count = last - first;
+    int16_t dst_x = x + first;
+
+    if ((y & 7) == 0) {
+        memcpy(frame + (y >> 3) * frame_width + dst_x, src, count);
+        return;
+    }
+
+    // The strip straddles two pages: its top rows go to the bottom of the
+    // first page and the rest to the top of the next one.
+    int16_t page = y >> 3;
+    uint8_t shift = y & 7;
+    if (page >= 0) {
+        uint8_t* dst = frame + page * frame_width + dst_x;
+        uint8_t keep = ~(0xFF << shift);
+        for (uint16_t i = 0; i < count; ++i)
+            dst[i] = (dst[i] & keep) | (src[i] << shift);
+    }
+    if (page + 1 < frame_pages) {
+        uint8_t* dst = frame + (page + 1) * frame_width + dst_x;
+        uint8_t keep = 0xFF << shift;
+        for (uint16_t i = 0; i < count; ++i)
+            dst[i] = (dst[i] & keep) | (src[i] >> (8 - shift));
+    }
+}
+
+uint8_t* NameBitmapCache::get_columns(uint8_t entry_num) const {
+    return _columns + (size_t) entry_num * _max_width;
+}
+
+void NameBitmapCache::rasterize(Entry& entry, uint8_t* columns) const {
+    Font const& font = *entry.p_font;
+    uint16_t width = 0;
+
+    for (const char* p = entry.name; *p != '\0' && width < _max_width; ++p) {
+        if (p != entry.name) {
+            for (uint8_t i = 0; i < font.glyph_spacing && width < _max_width; ++i)
+                columns[width++] = 0;
+        }
+        for (uint8_t i = 0; i < font.glyph_width && width < _max_width; ++i)
+            columns[width++] = font.glyph_column_fn(*p, i);
+    }
+
+    entry.width = width;
+}
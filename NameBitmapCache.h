@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#ifndef NAMEBITMAPCACHE_H
+#define NAMEBITMAPCACHE_H
+
+#include "MenuSystem.h"
+
+//! \brief A cache of pre-rasterized component names for bitmap renderers
+//!
+//! Renderers for bitmap displays usually draw a name glyph by glyph on every
+//! frame. NameBitmapCache rasterizes each name once into a strip of 1-bpp
+//! columns, 8 pixels high (bit 0 is the top row), and keeps the strips of the
+//! most recently used names. Drawing an unchanged name is then a single copy
+//! into the frame buffer with NameBitmapCache::blit.
+//!
+//! All storage is supplied by the client, so the cache uses a fixed amount of
+//! RAM; when it's full the least recently used strip is replaced.
+//!
+//! \code
+//! NameBitmapCache::Entry name_entries[4];
+//! uint8_t name_columns[4 * 84];
+//! NameBitmapCache name_cache(name_entries, 4, name_columns, 84);
+//! \endcode
+class NameBitmapCache {
+public:
+    //! \brief Returns one column of a glyph
+    //!
+    //! \param c The character.
+    //! \param column The column of the glyph, less than Font::glyph_width.
+    //! \returns The column's pixels; bit 0 is the top row.
+    using GlyphColumnFnPtr = uint8_t (*)(char c, uint8_t column);
+
+    //! \brief A fixed width font up to 8 pixels high
+    struct Font {
+        GlyphColumnFnPtr glyph_column_fn;
+        uint8_t glyph_width;
+        uint8_t glyph_spacing;
+    };
+
+    //! \brief A rasterized name
+    struct Strip {
+        uint8_t const* columns;
+        uint16_t width;
+    };
+
+    //! \brief A cache slot
+    struct Entry {
+        MenuComponent const* p_component;
+        Font const* p_font;
+        const char* name;
+        uint8_t name_version;
+        uint16_t width;
+        uint16_t last_used;
+    };
+
+public:
+    //! \brief Construct a NameBitmapCache
+    //!
+    //! \param[in] entries Storage for the cache slots.
+    //! \param[in] num_entries The number of elements in entries.
+    //! \param[in] columns Storage for the strips: num_entries * max_width
+    //!                    bytes.
+    //! \param[in] max_width The maximum width of a strip in pixels; longer
+    //!                      names are clipped.
+    NameBitmapCache(Entry* entries, uint8_t num_entries, uint8_t* columns,
+                    uint16_t max_width);
+
+    //! \brief Returns the strip of a component's name in the given font
+    //!
+    //! The name is rasterized only if it isn't cached or
+    //! MenuComponent::set_name was called since it was cached, even with the
+    //! same string rewritten in place.
+    Strip get(MenuComponent const& component, Font const& font);
+
+    //! \brief Discards all cached strips
+    void clear();
+
+    //! \brief Copies a strip into a page organised frame buffer
+    //!
+    //! The frame buffer layout is the one used by PCD8544 and SSD1306 style
+    //! controllers: `frame[page * frame_width + x]` holds the pixels of
+    //! column x for rows 8 * page to 8 * page + 7, bit 0 being the top row.
+    //! The 8 rows covered by the strip are overwritten; the strip is clipped
+    //! to the frame. Rows aligned to a page are copied with memcpy.
+    //!
+    //! \param[in] strip The strip to draw.
+    //! \param[in,out] frame The frame buffer.
+    //! \param[in] frame_width The width of the frame in pixels.
+    //! \param[in] frame_pages The height of the frame in pages of 8 rows.
+    //! \param[in] x The column of the strip's left edge.
+    //! \param[in] y The row of the strip's top edge.
+    static void blit(Strip const& strip, uint8_t* frame, uint16_t frame_width,
+                     uint8_t frame_pages, int16_t x, int16_t y);
+
+private:
+    uint8_t* get_columns(uint8_t entry_num) const;
+    void rasterize(Entry& entry, uint8_t* columns) const;
+
+private:
+    Entry* _entries;
+    uint8_t _num_entries;
+    uint8_t* _columns;
+    uint16_t _max_width;
+    uint16_t _tick;
+};
+
+#endif
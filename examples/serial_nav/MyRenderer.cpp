@@ -4,7 +4,9 @@ void MyRenderer::render(Menu const& menu) const {
     Serial.print("\nCurrent menu name: ");
     Serial.println(menu.get_name());
     String buffer;
-    for (int i = 0; i < menu.get_num_components(); ++i) {
+    Menu::ComponentIndex i;
+    for (bool found = menu.get_next_visible_component_num(0, i); found;
+            found = menu.get_next_visible_component_num(i + 1, i)) {
         MenuComponent const* cp_m_comp = menu.get_menu_component(i);
         cp_m_comp->render(*this);
 
@@ -68,6 +70,15 @@ void MyRenderer::render_custom_numeric_menu_item(CustomNumericMenuItem const& me
     }
 }
 
+void MyRenderer::render_choice_menu_item(ChoiceMenuItem const& menu_item) const {
+    Serial.print(menu_item.get_name());
+    Serial.print(menu_item.has_focus() ? '<' : '=');
+    Serial.print(menu_item.get_label());
+
+    if (menu_item.has_focus())
+        Serial.print('>');
+}
+
 void MyRenderer::render_menu(Menu const& menu) const {
     Serial.print(menu.get_name());
 }
@@ -22,6 +22,7 @@ public:
     void render_back_menu_item(BackMenuItem const& menu_item) const;
     void render_numeric_menu_item(NumericMenuItem const& menu_item) const;
     void render_custom_numeric_menu_item(CustomNumericMenuItem const& menu_item) const;
+    void render_choice_menu_item(ChoiceMenuItem const& menu_item) const;
     void render_menu(Menu const& menu) const;
 };
 
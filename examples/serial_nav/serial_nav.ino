@@ -17,6 +17,16 @@ const String format_int(const float value);
 const String format_color(const float value);
 void on_component_selected(MenuComponent* p_menu_component);
 
+// Choice tables (stored in flash)
+
+const char baud_label_0[] PROGMEM = "9600";
+const char baud_label_1[] PROGMEM = "57600";
+const char baud_label_2[] PROGMEM = "115200";
+const char* const baud_labels[] PROGMEM = {
+    baud_label_0, baud_label_1, baud_label_2
+};
+const int32_t baud_values[] PROGMEM = { 9600, 57600, 115200 };
+
 // Menu variables
 
 MyRenderer my_renderer;
@@ -31,6 +41,8 @@ NumericMenuItem mu1_mi2("Level 2 - Txt Item 2 (Item)", nullptr, 0, 0, 2, 1, form
 CustomNumericMenuItem mu1_mi3(12, "Level 2 - Cust Item 3 (Item)", 80, 65, 121, 3, format_int);
 NumericMenuItem mm_mi4("Level 1 - Float Item 4 (Item)", nullptr, 0.5, 0.0, 1.0, 0.1, format_float);
 NumericMenuItem mm_mi5("Level 1 - Int Item 5 (Item)", nullptr, 50, -100, 100, 1, format_int);
+ChoiceMenuItem mm_mi6("Level 1 - Baud Item 6 (Item)", &on_component_selected,
+                      baud_labels, 3, baud_values);
 
 // Menu callback function
 
@@ -87,6 +99,8 @@ void serial_handler() {
     char inChar;
     if ((inChar = Serial.read()) > 0) {
         Serial.println("\033c");
+        // The terminal was cleared, so render even if nothing changed
+        ms.invalidate();
         switch (inChar) {
             case 'w': // Previus item
                 ms.prev();
@@ -133,6 +147,7 @@ void setup() {
     mu1.add_item(&mu1_mi3);
     ms.get_root_menu().add_item(&mm_mi4);
     ms.get_root_menu().add_item(&mm_mi5);
+    ms.get_root_menu().add_item(&mm_mi6);
 
     display_help();
     ms.display();
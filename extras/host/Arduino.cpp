@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include "Arduino.h"
+#include <stdio.h>
+
+uint64_t host_nanos = 0;
+HostSerial Serial;
+
+void delay(unsigned long ms) {
+    host_nanos += ms * 1000000ULL;
+}
+
+void delayMicroseconds(unsigned int us) {
+    host_nanos += us * 1000ULL;
+}
+
+String::String(float value, unsigned char decimals) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+    assign(buffer);
+}
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t written = 0;
+    while (size--)
+        written += write(*buffer++);
+    return written;
+}
+
+size_t Print::print(const char* s) {
+    return write((const uint8_t*) s, strlen(s));
+}
+
+size_t Print::print(const String& s) {
+    return write((const uint8_t*) s.c_str(), s.size());
+}
+
+size_t Print::print(const __FlashStringHelper* s) {
+    return print((const char*) s);
+}
+
+size_t Print::print(char c) {
+    return write((uint8_t) c);
+}
+
+size_t Print::println(const char* s) {
+    return print(s) + print('\r') + print('\n');
+}
+
+size_t Stream::readBytes(uint8_t* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = read();
+        if (c < 0)
+            break;
+        buffer[count++] = (uint8_t) c;
+    }
+    return count;
+}
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+    return readBytes((uint8_t*) buffer, length);
+}
+
+int HostSerial::read() {
+    if (_input.empty())
+        return -1;
+    uint8_t c = _input[0];
+    _input.erase(0, 1);
+    return c;
+}
@@ -0,0 +1,101 @@
+/*
+ * Arduino.h - The subset of the Arduino core used by the library and its
+ * examples, so they can be built and benchmarked on the host. Time is
+ * simulated: it only advances with delay() and the simulated devices' bus
+ * transfers (see sim/SimBus.h).
+ *
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*) (addr))
+#define pgm_read_word(addr) (*(const uint16_t*) (addr))
+#define pgm_read_dword(addr) (*(const uint32_t*) (addr))
+#define pgm_read_float(addr) (*(const float*) (addr))
+#define pgm_read_ptr(addr) (*(const void* const*) (addr))
+
+class __FlashStringHelper;
+#define F(string_literal) \
+    (reinterpret_cast<const __FlashStringHelper*>(string_literal))
+
+//! The simulated time in nanoseconds
+extern uint64_t host_nanos;
+
+inline uint32_t millis() {
+    return host_nanos / 1000000;
+}
+
+inline uint32_t micros() {
+    return host_nanos / 1000;
+}
+
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+class String : public std::string {
+public:
+    String() {}
+    String(const char* s) : std::string(s) {}
+    String(int value) : std::string(std::to_string(value)) {}
+    String(float value, unsigned char decimals=2);
+
+    String& operator+=(const String& s) { append(s); return *this; }
+    String& operator+=(const char* s) { append(s); return *this; }
+    String& operator+=(char c) { push_back(c); return *this; }
+    String& operator+=(int value) { return *this += String(value); }
+    String& operator+=(float value) { return *this += String(value); }
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t value) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+
+    size_t print(const char* s);
+    size_t print(const String& s);
+    size_t print(const __FlashStringHelper* s);
+    size_t print(char c);
+    size_t println(const char* s="");
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    size_t readBytes(uint8_t* buffer, size_t length);
+    size_t readBytes(char* buffer, size_t length);
+};
+
+//! The serial port; reads return the bytes given to HostSerial::feed and
+//! writes are discarded.
+class HostSerial : public Stream {
+public:
+    void begin(unsigned long baud) {}
+    void feed(const char* s) { _input += s; }
+
+    int available() { return _input.size(); }
+    int read();
+    int peek() { return _input.empty() ? -1 : (uint8_t) _input[0]; }
+    size_t write(uint8_t value) { return 1; }
+
+private:
+    std::string _input;
+};
+
+extern HostSerial Serial;
+
+#endif
@@ -0,0 +1,156 @@
+/*
+ * blob_bench.cpp - Measures how long MenuBlobLoader takes to load a blob,
+ * in place from a memory mapped file and copied from a Stream.
+ *
+ *     ../menublob.py --generate 10000 > big.txt
+ *     ../menublob.py big.txt -o big.bin
+ *     ./blob_bench big.bin
+ *
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include <MenuBlob.h>
+#include <chrono>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+class NullRenderer : public MenuComponentRenderer {
+public:
+    void render(Menu const& menu) const {}
+    void render_menu_item(MenuItem const& menu_item) const {}
+    void render_back_menu_item(BackMenuItem const& menu_item) const {}
+    void render_numeric_menu_item(NumericMenuItem const& menu_item) const {}
+    void render_menu(Menu const& menu) const {}
+};
+
+//! A Stream over a buffer, standing in for an SD card File.
+class BufferStream : public Stream {
+public:
+    BufferStream(uint8_t const* data, size_t size)
+    : _data(data), _size(size), _position(0) {}
+
+    int available() { return _size - _position; }
+    int read() { return _position < _size ? _data[_position++] : -1; }
+    int peek() { return _position < _size ? _data[_position] : -1; }
+    size_t write(uint8_t value) { return 0; }
+
+private:
+    uint8_t const* _data;
+    size_t _size;
+    size_t _position;
+};
+
+// Counts the components of a loaded menu and its submenus.
+class Counter : public MenuComponentRenderer {
+public:
+    Counter() : count(0) {}
+
+    void render(Menu const& menu) const {}
+    void render_menu_item(MenuItem const& menu_item) const { ++count; }
+    void render_back_menu_item(BackMenuItem const& menu_item) const { ++count; }
+    void render_numeric_menu_item(NumericMenuItem const& menu_item) const {
+        ++count;
+    }
+
+    void render_menu(Menu const& menu) const {
+        ++count;
+        count_components(menu);
+    }
+
+    void count_components(Menu const& menu) const {
+        for (Menu::ComponentIndex i = 0; i < menu.get_num_components(); ++i)
+            menu.get_menu_component(i)->render(*this);
+    }
+
+    mutable size_t count;
+};
+
+void on_select(MenuComponent* p_menu_component) {}
+
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s BLOB [ITERATIONS]\n", argv[0]);
+        return 2;
+    }
+    int iterations = argc > 2 ? atoi(argv[2]) : 20;
+
+    int fd = open(argv[1], O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0 || st.st_size < MenuBlob::HEADER_SIZE) {
+        perror(argv[1]);
+        return 1;
+    }
+    uint8_t const* blob = (uint8_t const*) mmap(nullptr, st.st_size, PROT_READ,
+                                                MAP_PRIVATE, fd, 0);
+    if (blob == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+
+    // The blob's select function ids index this table; any function will do.
+    MenuComponent::SelectFnPtr select_fns[MenuBlob::NO_SELECT_FN];
+    for (auto& select_fn : select_fns)
+        select_fn = on_select;
+
+    printf("%s: %ld bytes\n", argv[1], (long) st.st_size);
+    printf("%-10s %10s %12s %12s %12s\n", "mode", "components", "arena bytes",
+           "min us", "mean us");
+
+    NullRenderer renderer;
+    for (int copy_names = 0; copy_names < 2; ++copy_names) {
+        std::vector<uint8_t> arena(MenuBlobLoader::get_arena_size(blob,
+                                                                  copy_names));
+        double min_us = 0;
+        double total_us = 0;
+        size_t count = 0;
+        size_t arena_used = 0;
+
+        for (int i = 0; i < iterations; ++i) {
+            // Menus don't free their component lists, so every iteration
+            // leaks them; that's fine for a benchmark.
+            MenuSystem* p_menu_system = new MenuSystem(renderer);
+            MenuBlobLoader loader(*p_menu_system, arena.data(), arena.size());
+            loader.set_select_functions(select_fns, MenuBlob::NO_SELECT_FN);
+            BufferStream in(blob, st.st_size);
+
+            auto start = std::chrono::steady_clock::now();
+            bool loaded = copy_names
+                ? loader.load(p_menu_system->get_root_menu(), in)
+                : loader.load(p_menu_system->get_root_menu(), blob, st.st_size);
+            auto end = std::chrono::steady_clock::now();
+
+            if (!loaded) {
+                fprintf(stderr, "load failed: error %d\n", loader.get_error());
+                return 1;
+            }
+
+            double us = std::chrono::duration<double, std::micro>(end - start)
+                        .count();
+            min_us = i == 0 || us < min_us ? us : min_us;
+            total_us += us;
+
+            Counter counter;
+            counter.count_components(p_menu_system->get_root_menu());
+            count = counter.count;
+            arena_used = loader.get_arena_used();
+            delete p_menu_system;
+        }
+
+        printf("%-10s %10zu %12zu %12.1f %12.1f\n",
+               copy_names ? "stream" : "in place", count, arena_used, min_us,
+               total_us / iterations);
+    }
+
+    munmap((void*) blob, st.st_size);
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,114 @@
+/*
+ * render_bench.cpp - Drives an example sketch against the simulated displays
+ * in sim/ and reports the simulated time from each key press to the
+ * finished frame, and the bytes sent to the display.
+ *
+ * Link it with an example compiled for the host (see the Makefile) and give
+ * it the keys to press, in the examples' serial protocol: w (prev), s
+ * (next), a (back) and d (select).
+ *
+ *     ./render_bench_lcd_nav sswwssdaws
+ *
+ * The times are deterministic, so they can be compared between builds.
+ * Select callbacks that call delay() are included in the time.
+ *
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "sim/SimBus.h"
+
+#ifndef RENDER_BENCH_EXAMPLE
+  #define RENDER_BENCH_EXAMPLE "example"
+#endif
+
+void setup();
+void loop();
+
+namespace {
+
+const char DEFAULT_KEYS[] = "sswwssdaws";
+
+struct Action {
+    char key;
+    const char* name;
+    uint32_t count;
+    uint64_t total_nanos;
+    uint64_t max_nanos;
+    uint32_t total_bytes;
+};
+
+void print_row(const char* name, uint32_t count, uint64_t total_nanos,
+               uint64_t max_nanos, uint32_t total_bytes) {
+    if (count == 0)
+        return;
+    printf("%-10s %6u %12.1f %12.1f %12.1f\n", name, count,
+           total_nanos / 1000.0 / count, max_nanos / 1000.0,
+           (double) total_bytes / count);
+}
+
+}
+
+int main(int argc, char** argv) {
+    const char* keys = argc > 1 ? argv[1] : DEFAULT_KEYS;
+
+    Action actions[] = {
+        { 'w', "prev", 0, 0, 0, 0 },
+        { 's', "next", 0, 0, 0, 0 },
+        { 'a', "back", 0, 0, 0, 0 },
+        { 'd', "select", 0, 0, 0, 0 }
+    };
+    const size_t num_actions = sizeof(actions) / sizeof(actions[0]);
+
+    setup();
+    uint64_t setup_nanos = host_nanos;
+    uint32_t setup_bytes = SimBus::get_bytes();
+
+    uint32_t count = 0;
+    uint64_t total_nanos = 0;
+    uint64_t max_nanos = 0;
+    uint32_t total_bytes = 0;
+    for (const char* p = keys; *p != '\0'; ++p) {
+        Action* p_action = nullptr;
+        for (size_t i = 0; i < num_actions; ++i)
+            if (actions[i].key == *p)
+                p_action = &actions[i];
+        if (p_action == nullptr) {
+            fprintf(stderr, "unknown key '%c'\n", *p);
+            return 2;
+        }
+
+        uint64_t start_nanos = host_nanos;
+        uint32_t start_bytes = SimBus::get_bytes();
+        char input[] = { *p, '\0' };
+        Serial.feed(input);
+        while (Serial.available())
+            loop();
+        uint64_t nanos = host_nanos - start_nanos;
+        uint32_t bytes = SimBus::get_bytes() - start_bytes;
+
+        p_action->count++;
+        p_action->total_nanos += nanos;
+        p_action->total_bytes += bytes;
+        if (nanos > p_action->max_nanos)
+            p_action->max_nanos = nanos;
+
+        count++;
+        total_nanos += nanos;
+        total_bytes += bytes;
+        if (nanos > max_nanos)
+            max_nanos = nanos;
+    }
+
+    printf("%s: setup %.1f us, %u bytes\n", RENDER_BENCH_EXAMPLE,
+           setup_nanos / 1000.0, setup_bytes);
+    printf("%-10s %6s %12s %12s %12s\n", "action", "count", "mean us",
+           "max us", "mean bytes");
+    for (size_t i = 0; i < num_actions; ++i)
+        print_row(actions[i].name, actions[i].count, actions[i].total_nanos,
+                  actions[i].max_nanos, actions[i].total_bytes);
+    print_row("all", count, total_nanos, max_nanos, total_bytes);
+    return 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include "Adafruit_GFX.h"
+#include "SimFont.h"
+
+Adafruit_GFX::Adafruit_GFX(int16_t width, int16_t height)
+: _width(width),
+  _height(height),
+  cursor_x(0),
+  cursor_y(0),
+  textcolor(1),
+  textsize(1),
+  wrap(true) {
+}
+
+void Adafruit_GFX::setCursor(int16_t x, int16_t y) {
+    cursor_x = x;
+    cursor_y = y;
+}
+
+void Adafruit_GFX::setTextSize(uint8_t size) {
+    textsize = size > 0 ? size : 1;
+}
+
+void Adafruit_GFX::setTextColor(uint16_t color) {
+    textcolor = color;
+}
+
+void Adafruit_GFX::setTextWrap(bool wrap) {
+    this->wrap = wrap;
+}
+
+int16_t Adafruit_GFX::width() const {
+    return _width;
+}
+
+int16_t Adafruit_GFX::height() const {
+    return _height;
+}
+
+size_t Adafruit_GFX::write(uint8_t c) {
+    if (c == '\n') {
+        cursor_y += textsize * 8;
+        cursor_x = 0;
+    } else if (c != '\r') {
+        if (wrap && cursor_x + textsize * 6 > _width) {
+            cursor_x = 0;
+            cursor_y += textsize * 8;
+        }
+        drawChar(cursor_x, cursor_y, c, textcolor, textsize);
+        cursor_x += textsize * 6;
+    }
+    return 1;
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, uint8_t c, uint16_t color,
+                            uint8_t size) {
+    for (uint8_t i = 0; i < 5; ++i) {
+        uint8_t line = sim_glyph_column(c, i);
+        for (uint8_t j = 0; j < 8; ++j, line >>= 1) {
+            if (!(line & 1))
+                continue;
+            for (uint8_t dx = 0; dx < size; ++dx)
+                for (uint8_t dy = 0; dy < size; ++dy)
+                    drawPixel(x + i * size + dx, y + j * size + dy, color);
+        }
+    }
+}
@@ -0,0 +1,48 @@
+/*
+ * Adafruit_GFX.h - The text drawing subset of the Adafruit GFX library used
+ * by the simulated displays.
+ *
+ * Characters are 5x7 glyphs in 6x8 cells like the library's built in font,
+ * drawn with the placeholder font of SimFont.h.
+ *
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#ifndef ADAFRUIT_GFX_H
+#define ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+
+class Adafruit_GFX : public Print {
+public:
+    Adafruit_GFX(int16_t width, int16_t height);
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+    void setCursor(int16_t x, int16_t y);
+    void setTextSize(uint8_t size);
+    void setTextColor(uint16_t color);
+    void setTextWrap(bool wrap);
+
+    int16_t width() const;
+    int16_t height() const;
+
+    size_t write(uint8_t c);
+    using Print::write;
+
+protected:
+    void drawChar(int16_t x, int16_t y, uint8_t c, uint16_t color,
+                  uint8_t size);
+
+protected:
+    const int16_t _width;
+    const int16_t _height;
+    int16_t cursor_x;
+    int16_t cursor_y;
+    uint16_t textcolor;
+    uint8_t textsize;
+    bool wrap;
+};
+
+#endif
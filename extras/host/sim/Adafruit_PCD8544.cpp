@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include "Adafruit_PCD8544.h"
+#include "SimBus.h"
+
+namespace {
+
+const uint8_t PCD8544_FUNCTIONSET = 0x20;
+const uint8_t PCD8544_EXTENDEDINSTRUCTION = 0x01;
+const uint8_t PCD8544_DISPLAYCONTROL = 0x08;
+const uint8_t PCD8544_DISPLAYNORMAL = 0x04;
+const uint8_t PCD8544_SETYADDR = 0x40;
+const uint8_t PCD8544_SETXADDR = 0x80;
+const uint8_t PCD8544_SETBIAS = 0x10;
+const uint8_t PCD8544_SETVOP = 0x80;
+
+}
+
+Adafruit_PCD8544::Adafruit_PCD8544(int8_t sclk, int8_t din, int8_t dc,
+                                   int8_t cs, int8_t rst)
+: Adafruit_GFX(LCDWIDTH, LCDHEIGHT),
+  _hardware_spi(false) {
+    memset(_buffer, 0, sizeof(_buffer));
+}
+
+Adafruit_PCD8544::Adafruit_PCD8544(int8_t dc, int8_t cs, int8_t rst)
+: Adafruit_GFX(LCDWIDTH, LCDHEIGHT),
+  _hardware_spi(true) {
+    memset(_buffer, 0, sizeof(_buffer));
+}
+
+void Adafruit_PCD8544::begin(uint8_t contrast, uint8_t bias) {
+    // Reset pulse
+    SimBus::digital_write(2);
+    SimBus::wait(500000);
+
+    command(PCD8544_FUNCTIONSET | PCD8544_EXTENDEDINSTRUCTION);
+    command(PCD8544_SETBIAS | bias);
+    command(PCD8544_SETVOP | (contrast > 0x7F ? 0x7F : contrast));
+    command(PCD8544_FUNCTIONSET);
+    command(PCD8544_DISPLAYCONTROL | PCD8544_DISPLAYNORMAL);
+}
+
+void Adafruit_PCD8544::setContrast(uint8_t contrast) {
+    command(PCD8544_FUNCTIONSET | PCD8544_EXTENDEDINSTRUCTION);
+    command(PCD8544_SETVOP | (contrast > 0x7F ? 0x7F : contrast));
+    command(PCD8544_FUNCTIONSET);
+}
+
+void Adafruit_PCD8544::clearDisplay() {
+    memset(_buffer, 0, sizeof(_buffer));
+    cursor_x = 0;
+    cursor_y = 0;
+}
+
+void Adafruit_PCD8544::display() {
+    for (uint8_t page = 0; page < LCDHEIGHT / 8; ++page) {
+        command(PCD8544_SETYADDR | page);
+        command(PCD8544_SETXADDR);
+
+        // D/C high, CS low, the page, CS high
+        SimBus::digital_write(3);
+        for (uint8_t col = 0; col < LCDWIDTH; ++col)
+            spi_write(_buffer[page * LCDWIDTH + col]);
+    }
+    command(PCD8544_SETYADDR);
+}
+
+void Adafruit_PCD8544::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if (x < 0 || x >= LCDWIDTH || y < 0 || y >= LCDHEIGHT)
+        return;
+
+    uint8_t& cell = _buffer[x + (y / 8) * LCDWIDTH];
+    if (color)
+        cell |= 1 << (y % 8);
+    else
+        cell &= ~(1 << (y % 8));
+}
+
+uint8_t Adafruit_PCD8544::getPixel(int8_t x, int8_t y) const {
+    if (x < 0 || x >= LCDWIDTH || y < 0 || y >= LCDHEIGHT)
+        return 0;
+    return (_buffer[x + (y / 8) * LCDWIDTH] >> (y % 8)) & 1;
+}
+
+void Adafruit_PCD8544::command(uint8_t value) {
+    // D/C low, CS low, the command, CS high
+    SimBus::digital_write(3);
+    spi_write(value);
+}
+
+void Adafruit_PCD8544::spi_write(uint8_t value) {
+    if (_hardware_spi)
+        SimBus::transfer(1, 8 * 1000000000ULL / PCD8544_SPI_CLOCK_HZ
+                            + PCD8544_SPI_OVERHEAD_NS);
+    else
+        SimBus::transfer(1, 8 * PCD8544_SOFT_SPI_BIT_NS);
+}
@@ -0,0 +1,65 @@
+/*
+ * Adafruit_PCD8544.h - A simulated PCD8544 84x48 LCD with the interface of
+ * the Adafruit PCD8544 library.
+ *
+ * display() sends the whole frame buffer like the library does: for each of
+ * the six pages two address commands and 84 data bytes. With hardware SPI a
+ * byte takes 8 clocks at PCD8544_SPI_CLOCK_HZ plus the transfer overhead;
+ * with software SPI every bit costs PCD8544_SOFT_SPI_BIT_NS.
+ *
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#ifndef ADAFRUIT_PCD8544_H
+#define ADAFRUIT_PCD8544_H
+
+#include "Adafruit_GFX.h"
+
+//! \brief The hardware SPI clock; the library uses SPI_CLOCK_DIV4
+#ifndef PCD8544_SPI_CLOCK_HZ
+  #define PCD8544_SPI_CLOCK_HZ 4000000
+#endif
+
+//! \brief The time SPI.transfer spends around each byte
+#ifndef PCD8544_SPI_OVERHEAD_NS
+  #define PCD8544_SPI_OVERHEAD_NS 500
+#endif
+
+//! \brief The time of one bit with software SPI
+#ifndef PCD8544_SOFT_SPI_BIT_NS
+  #define PCD8544_SOFT_SPI_BIT_NS 1000
+#endif
+
+#define BLACK 1
+#define WHITE 0
+
+#define LCDWIDTH 84
+#define LCDHEIGHT 48
+
+class Adafruit_PCD8544 : public Adafruit_GFX {
+public:
+    //! Software SPI
+    Adafruit_PCD8544(int8_t sclk, int8_t din, int8_t dc, int8_t cs,
+                     int8_t rst);
+    //! Hardware SPI
+    Adafruit_PCD8544(int8_t dc, int8_t cs, int8_t rst);
+
+    void begin(uint8_t contrast=40, uint8_t bias=0x04);
+    void setContrast(uint8_t contrast);
+    void clearDisplay();
+    void display();
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color);
+    uint8_t getPixel(int8_t x, int8_t y) const;
+
+private:
+    void command(uint8_t value);
+    void spi_write(uint8_t value);
+
+private:
+    uint8_t _buffer[LCDWIDTH * LCDHEIGHT / 8];
+    bool _hardware_spi;
+};
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include "LiquidCrystal.h"
+#include "SimBus.h"
+
+namespace {
+
+const uint8_t LCD_CLEARDISPLAY = 0x01;
+const uint8_t LCD_RETURNHOME = 0x02;
+const uint8_t LCD_ENTRYMODESET = 0x04;
+const uint8_t LCD_DISPLAYCONTROL = 0x08;
+const uint8_t LCD_FUNCTIONSET = 0x20;
+const uint8_t LCD_SETDDRAMADDR = 0x80;
+
+}
+
+LiquidCrystal::LiquidCrystal(uint8_t rs, uint8_t enable, uint8_t d0,
+                             uint8_t d1, uint8_t d2, uint8_t d3)
+: _address(0),
+  _cols(16),
+  _rows(1) {
+    memset(_ddram, ' ', sizeof(_ddram));
+    memset(_row_offsets, 0, sizeof(_row_offsets));
+}
+
+void LiquidCrystal::begin(uint8_t cols, uint8_t rows) {
+    _cols = cols;
+    _rows = rows;
+    _row_offsets[0] = 0x00;
+    _row_offsets[1] = 0x40;
+    _row_offsets[2] = 0x00 + cols;
+    _row_offsets[3] = 0x40 + cols;
+
+    // The power on sequence that puts the controller in 4-bit mode
+    SimBus::wait(50000000);
+    SimBus::digital_write(2);
+    for (uint8_t i = 0; i < 3; ++i) {
+        write4bits();
+        SimBus::wait(4500000);
+    }
+    write4bits();
+
+    command(LCD_FUNCTIONSET | (rows > 1 ? 0x08 : 0));
+    command(LCD_DISPLAYCONTROL | 0x04);
+    clear();
+    command(LCD_ENTRYMODESET | 0x02);
+}
+
+void LiquidCrystal::clear() {
+    command(LCD_CLEARDISPLAY);
+    SimBus::wait(2000000);
+    memset(_ddram, ' ', sizeof(_ddram));
+    _address = 0;
+}
+
+void LiquidCrystal::home() {
+    command(LCD_RETURNHOME);
+    SimBus::wait(2000000);
+    _address = 0;
+}
+
+void LiquidCrystal::setCursor(uint8_t col, uint8_t row) {
+    if (row >= 4)
+        row = 3;
+    if (row >= _rows)
+        row = _rows - 1;
+    command(LCD_SETDDRAMADDR | (col + _row_offsets[row]));
+}
+
+size_t LiquidCrystal::write(uint8_t value) {
+    send(value, true);
+    return 1;
+}
+
+std::string LiquidCrystal::get_row(uint8_t row) const {
+    return std::string((const char*) _ddram + _row_offsets[row], _cols);
+}
+
+void LiquidCrystal::command(uint8_t value) {
+    send(value, false);
+}
+
+void LiquidCrystal::send(uint8_t value, bool data) {
+    SimBus::digital_write();
+    write4bits();
+    write4bits();
+    SimBus::transfer(1, 0);
+
+    if (!data) {
+        if (value & LCD_SETDDRAMADDR)
+            _address = value & 0x7F;
+        return;
+    }
+
+    // In two line mode DDRAM holds 40 characters per line, at 0x00 and 0x40
+    _ddram[_address] = value;
+    if (_address == 0x27)
+        _address = 0x40;
+    else if (_address == 0x67)
+        _address = 0x00;
+    else
+        _address = (_address + 1) & 0x7F;
+}
+
+void LiquidCrystal::write4bits() {
+    // Four data lines, then pulseEnable: three writes and 1 + 1 + 100 us
+    SimBus::digital_write(7);
+    SimBus::wait(102000);
+}
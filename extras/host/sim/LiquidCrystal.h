@@ -0,0 +1,47 @@
+/*
+ * LiquidCrystal.h - A simulated HD44780 character LCD with the interface of
+ * the Arduino LiquidCrystal library in 4-bit mode.
+ *
+ * Timing follows the library: every nibble is set with four digitalWrite
+ * calls and latched by pulseEnable, which waits 102 us; clear and home wait
+ * another 2 ms.
+ *
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#ifndef LIQUIDCRYSTAL_H
+#define LIQUIDCRYSTAL_H
+
+#include <Arduino.h>
+
+class LiquidCrystal : public Print {
+public:
+    LiquidCrystal(uint8_t rs, uint8_t enable, uint8_t d0, uint8_t d1,
+                  uint8_t d2, uint8_t d3);
+
+    void begin(uint8_t cols, uint8_t rows);
+    void clear();
+    void home();
+    void setCursor(uint8_t col, uint8_t row);
+
+    size_t write(uint8_t value);
+    using Print::write;
+
+    //! \brief Returns the visible characters of a row
+    std::string get_row(uint8_t row) const;
+
+private:
+    void command(uint8_t value);
+    void send(uint8_t value, bool data);
+    void write4bits();
+
+private:
+    uint8_t _ddram[0x80];
+    uint8_t _row_offsets[4];
+    uint8_t _address;
+    uint8_t _cols;
+    uint8_t _rows;
+};
+
+#endif
@@ -0,0 +1,14 @@
+/*
+ * SPI.h - Placeholder for the Arduino SPI library; the simulated devices
+ * account for their SPI transfers themselves.
+ *
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#ifndef SPI_H
+#define SPI_H
+
+#include <Arduino.h>
+
+#endif
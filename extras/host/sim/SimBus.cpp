@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include "SimBus.h"
+
+uint32_t SimBus::_bytes = 0;
+uint64_t SimBus::_nanos = 0;
+
+void SimBus::transfer(uint32_t num_bytes, uint64_t nanos) {
+    _bytes += num_bytes;
+    wait(nanos);
+}
+
+void SimBus::wait(uint64_t nanos) {
+    _nanos += nanos;
+    host_nanos += nanos;
+}
+
+void SimBus::digital_write(uint8_t count) {
+    wait((uint64_t) count * SIM_DIGITAL_WRITE_NS);
+}
+
+uint32_t SimBus::get_bytes() {
+    return _bytes;
+}
+
+uint64_t SimBus::get_nanos() {
+    return _nanos;
+}
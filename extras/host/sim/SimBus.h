@@ -0,0 +1,47 @@
+/*
+ * SimBus.h - Accounts for the bus traffic of the simulated displays.
+ *
+ * The simulated drivers report every transfer with its duration, which
+ * advances the simulated time (host_nanos). Durations follow the drivers'
+ * own busy waits and a model of the bus; the CPU time spent drawing into
+ * frame buffers is not modelled.
+ *
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#ifndef SIMBUS_H
+#define SIMBUS_H
+
+#include <Arduino.h>
+
+//! \brief The duration of a digitalWrite call on a 16 MHz AVR
+#ifndef SIM_DIGITAL_WRITE_NS
+  #define SIM_DIGITAL_WRITE_NS 3500
+#endif
+
+class SimBus {
+public:
+    //! \brief Records bytes sent to a device
+    //! \param[in] num_bytes The number of bytes.
+    //! \param[in] nanos How long sending them took.
+    static void transfer(uint32_t num_bytes, uint64_t nanos);
+
+    //! \brief Records time spent driving control lines or waiting
+    static void wait(uint64_t nanos);
+
+    //! \brief Records calls to digitalWrite
+    static void digital_write(uint8_t count=1);
+
+    //! \brief Returns the number of bytes sent since the start
+    static uint32_t get_bytes();
+
+    //! \brief Returns the time spent on the bus since the start
+    static uint64_t get_nanos();
+
+private:
+    static uint32_t _bytes;
+    static uint64_t _nanos;
+};
+
+#endif
@@ -0,0 +1,21 @@
+/*
+ * SimFont.h - The placeholder 5x7 font of the simulated displays. The glyphs
+ * only need to touch the frame buffers like real text would.
+ *
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#ifndef SIMFONT_H
+#define SIMFONT_H
+
+#include <Arduino.h>
+
+//! \brief Returns a column of a glyph; bit 0 is the top row
+inline uint8_t sim_glyph_column(uint8_t c, uint8_t column) {
+    if (c <= ' ')
+        return 0;
+    return (uint8_t) (c * 37 + column * 11) & 0x7F;
+}
+
+#endif
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include "ht1632c.h"
+#include "SimBus.h"
+#include "SimFont.h"
+
+volatile uint8_t PORTB = 0;
+
+namespace {
+
+const uint8_t CHIPS_PER_BOARD = 4;
+const uint16_t CHIP_RAM_BITS = 256;
+const uint8_t COMMAND_BITS = 3 + 7;
+
+}
+
+ht1632c::ht1632c(volatile uint8_t* port, uint8_t data, uint8_t wr,
+                 uint8_t clk, uint8_t cs, uint8_t geometry, uint8_t number)
+: _width(geometry * number),
+  _height(16),
+  _num_boards(number) {
+    _frame = new uint8_t[_width * _height];
+    memset(_frame, BLACK, _width * _height);
+}
+
+ht1632c::~ht1632c() {
+    delete[] _frame;
+}
+
+void ht1632c::clear() {
+    memset(_frame, BLACK, _width * _height);
+}
+
+void ht1632c::setfont(uint8_t font) {
+}
+
+void ht1632c::plot(int x, int y, uint8_t color) {
+    if (x < 0 || x >= _width || y < 0 || y >= _height)
+        return;
+    _frame[y * _width + x] = color;
+}
+
+uint8_t ht1632c::putchar(int x, int y, char c, uint8_t color, uint8_t attr,
+                         uint8_t bgcolor) {
+    for (uint8_t i = 0; i < 5; ++i) {
+        uint8_t line = sim_glyph_column(c, i);
+        for (uint8_t j = 0; j < 7; ++j, line >>= 1)
+            plot(x + i, y + j, (line & 1) ? color : bgcolor);
+    }
+    return 5;
+}
+
+void ht1632c::sendframe() {
+    const uint16_t chip_bits = HT1632C_SELECT_BITS + COMMAND_BITS
+                               + CHIP_RAM_BITS;
+    for (uint8_t chip = 0; chip < _num_boards * CHIPS_PER_BOARD; ++chip)
+        SimBus::transfer((COMMAND_BITS + CHIP_RAM_BITS + 7) / 8,
+                         (uint64_t) chip_bits * HT1632C_BIT_NS);
+}
+
+uint8_t ht1632c::get_pixel(int x, int y) const {
+    if (x < 0 || x >= _width || y < 0 || y >= _height)
+        return BLACK;
+    return _frame[y * _width + x];
+}
@@ -0,0 +1,63 @@
+/*
+ * ht1632c.h - A simulated Sure Electronics 32x16 bicolor LED matrix with the
+ * interface of the ht1632c library.
+ *
+ * Each board has four HT1632C controllers driving 16x8 LEDs in two colors.
+ * sendframe() selects every controller in turn and writes its 256 bits of
+ * display RAM in successive address mode after the 3-bit write ID and 7-bit
+ * address. The library bit-bangs the serial bus with direct port writes;
+ * HT1632C_BIT_NS is the time of one bit and HT1632C_SELECT_BITS the number
+ * of bit times spent selecting a controller. clear() only clears the frame
+ * buffer.
+ *
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#ifndef HT1632C_H
+#define HT1632C_H
+
+#include <Arduino.h>
+
+#ifndef HT1632C_BIT_NS
+  #define HT1632C_BIT_NS 1000
+#endif
+
+#ifndef HT1632C_SELECT_BITS
+  #define HT1632C_SELECT_BITS 4
+#endif
+
+#define GEOM_32x16 32
+
+#define BLACK 0
+#define GREEN 1
+#define RED 2
+#define ORANGE 3
+
+#define FONT_5x7 0
+
+extern volatile uint8_t PORTB;
+
+class ht1632c {
+public:
+    ht1632c(volatile uint8_t* port, uint8_t data, uint8_t wr, uint8_t clk,
+            uint8_t cs, uint8_t geometry, uint8_t number);
+    ~ht1632c();
+
+    void clear();
+    void setfont(uint8_t font);
+    void plot(int x, int y, uint8_t color);
+    uint8_t putchar(int x, int y, char c, uint8_t color=GREEN,
+                    uint8_t attr=0, uint8_t bgcolor=BLACK);
+    void sendframe();
+
+    uint8_t get_pixel(int x, int y) const;
+
+private:
+    uint8_t* _frame;
+    uint16_t _width;
+    uint16_t _height;
+    uint8_t _num_boards;
+};
+
+#endif
@@ -0,0 +1,66 @@
+/*
+ * test.h - Minimal helpers for the host tests run by `make check`.
+ *
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <MenuSystem.h>
+#include <stdio.h>
+
+//! Records a failure, with its location, if cond is false.
+#define CHECK(cond) test_check((cond), #cond, __FILE__, __LINE__)
+
+//! Records a failure if a and b differ, printing both.
+#define CHECK_EQUAL(a, b) \
+    test_check_equal((long long) (a), (long long) (b), #a, #b, __FILE__, \
+                     __LINE__)
+
+extern int test_failures;
+
+inline bool test_check(bool ok, const char* expr, const char* file,
+                       int line) {
+    if (!ok) {
+        fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expr);
+        ++test_failures;
+    }
+    return ok;
+}
+
+inline bool test_check_equal(long long a, long long b, const char* expr_a,
+                             const char* expr_b, const char* file, int line) {
+    if (a != b) {
+        fprintf(stderr, "%s:%d: %s == %s failed: %lld != %lld\n", file, line,
+                expr_a, expr_b, a, b);
+        ++test_failures;
+    }
+    return a == b;
+}
+
+//! Prints the result of a test program; returns its exit status.
+inline int test_result(const char* name) {
+    if (test_failures)
+        printf("%s: %d failure(s)\n", name, test_failures);
+    else
+        printf("%s: ok\n", name);
+    return test_failures ? 1 : 0;
+}
+
+//! A renderer that counts the menus it renders.
+class CountingRenderer : public MenuComponentRenderer {
+public:
+    CountingRenderer() : num_renders(0) {}
+
+    void render(Menu const& menu) const { ++num_renders; }
+    void render_menu_item(MenuItem const& menu_item) const {}
+    void render_back_menu_item(BackMenuItem const& menu_item) const {}
+    void render_numeric_menu_item(NumericMenuItem const& menu_item) const {}
+    void render_menu(Menu const& menu) const {}
+
+    mutable int num_renders;
+};
+
+#endif
@@ -0,0 +1,193 @@
+/*
+ * test_blob.cpp - Tests loading menu trees with MenuBlobLoader, and that a
+ * failed load leaves the menu and the arena as they were.
+ *
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include "test.h"
+#include <MenuBlob.h>
+#include <string.h>
+#include <vector>
+
+int test_failures = 0;
+
+namespace {
+
+int num_selects = 0;
+
+void on_select(MenuComponent* p_menu_component) {
+    ++num_selects;
+}
+
+MenuComponent::SelectFnPtr select_fns[] = { on_select };
+
+class BlobWriter {
+public:
+    void add_uint8(uint8_t value) {
+        bytes.push_back(value);
+    }
+
+    void add_uint16(uint16_t value) {
+        add_uint8(value & 0xFF);
+        add_uint8(value >> 8);
+    }
+
+    void add_float(float value) {
+        uint8_t float_bytes[sizeof(float)];
+        memcpy(float_bytes, &value, sizeof(float));
+        bytes.insert(bytes.end(), float_bytes, float_bytes + sizeof(float));
+    }
+
+    void add_name(const char* name) {
+        bytes.insert(bytes.end(), name, name + strlen(name) + 1);
+    }
+
+    void add_node(MenuBlob::NodeType type, uint8_t flags, uint8_t select_fn) {
+        add_uint8(type);
+        add_uint8(flags);
+        add_uint8(select_fn);
+    }
+
+    std::vector<uint8_t> bytes;
+};
+
+//! The blob of
+//!
+//!     menu "settings"
+//!         numeric "contrast" value=5 min=0 max=10 increment=1 select=on_select
+//!         menu "advanced"
+//!             item "reset" select=on_select disabled
+//!         back "back"
+//!     item "about" hidden
+std::vector<uint8_t> make_blob() {
+    BlobWriter blob;
+    blob.add_uint16(MenuBlob::MAGIC);
+    blob.add_uint8(MenuBlob::VERSION);
+    blob.add_uint8(0);
+    blob.add_uint16(2);     // root components
+    blob.add_uint16(2);     // menus
+    blob.add_uint16(2);     // items
+    blob.add_uint16(1);     // back items
+    blob.add_uint16(1);     // numeric items
+    blob.add_uint16(44);    // length of the names
+    blob.add_uint16(0);
+
+    blob.add_node(MenuBlob::NODE_MENU, 0, MenuBlob::NO_SELECT_FN);
+    blob.add_uint16(3);
+    blob.add_name("settings");
+    blob.add_node(MenuBlob::NODE_NUMERIC_ITEM, 0, 0);
+    blob.add_float(5);
+    blob.add_float(0);
+    blob.add_float(10);
+    blob.add_float(1);
+    blob.add_name("contrast");
+    blob.add_node(MenuBlob::NODE_MENU, 0, MenuBlob::NO_SELECT_FN);
+    blob.add_uint16(1);
+    blob.add_name("advanced");
+    blob.add_node(MenuBlob::NODE_ITEM, MenuBlob::FLAG_DISABLED, 0);
+    blob.add_name("reset");
+    blob.add_node(MenuBlob::NODE_BACK_ITEM, 0, MenuBlob::NO_SELECT_FN);
+    blob.add_name("back");
+    blob.add_node(MenuBlob::NODE_ITEM, MenuBlob::FLAG_HIDDEN,
+                  MenuBlob::NO_SELECT_FN);
+    blob.add_name("about");
+    return blob.bytes;
+}
+
+void test_load() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    std::vector<uint8_t> blob = make_blob();
+    alignas(8) uint8_t arena[1024];
+    MenuBlobLoader loader(ms, arena, sizeof(arena));
+    loader.set_select_functions(select_fns, 1);
+
+    CHECK(loader.load(ms.get_root_menu(), blob.data(), blob.size()));
+    CHECK_EQUAL(loader.get_error(), MenuBlobLoader::ERROR_NONE);
+    CHECK(loader.get_arena_used() <= MenuBlobLoader::get_arena_size(blob.data(),
+                                                                    false));
+
+    Menu const& root = ms.get_root_menu();
+    CHECK_EQUAL(root.get_num_components(), 2);
+    CHECK(!root.is_component_visible(1));
+    CHECK(strcmp(root.get_menu_component(1)->get_name(), "about") == 0);
+
+    Menu const* p_settings =
+        static_cast<Menu const*>(root.get_menu_component(0));
+    CHECK_EQUAL(p_settings->get_type(), MenuComponent::TYPE_MENU);
+    CHECK_EQUAL(p_settings->get_num_components(), 3);
+    CHECK_EQUAL(p_settings->get_menu_component(2)->get_type(),
+                MenuComponent::TYPE_BACK_MENU_ITEM);
+
+    NumericMenuItem const* p_contrast = static_cast<NumericMenuItem const*>(
+        p_settings->get_menu_component(0));
+    CHECK_EQUAL(p_contrast->get_type(), MenuComponent::TYPE_NUMERIC_MENU_ITEM);
+    CHECK_EQUAL(p_contrast->get_value(), 5);
+    CHECK_EQUAL(p_contrast->get_max_value(), 10);
+
+    Menu const* p_advanced =
+        static_cast<Menu const*>(p_settings->get_menu_component(1));
+    CHECK_EQUAL(p_advanced->get_num_components(), 1);
+    CHECK(!p_advanced->is_component_enabled(0));
+
+    // Select the contrast, commit it, then go back with the back item
+    num_selects = 0;
+    ms.select();
+    ms.select();
+    ms.select();
+    CHECK_EQUAL(num_selects, 1);
+    ms.next();
+    ms.next();
+    ms.select();
+    CHECK(ms.get_current_menu() == &ms.get_root_menu());
+}
+
+void test_failed_loads() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    MenuItem item("item", nullptr);
+    ms.get_root_menu().add_item(&item);
+    std::vector<uint8_t> blob = make_blob();
+    alignas(8) uint8_t arena[1024];
+    MenuBlobLoader loader(ms, arena, sizeof(arena));
+    loader.set_select_functions(select_fns, 1);
+
+    // Every truncation fails after building part of the tree
+    for (size_t size = 0; size < blob.size(); ++size) {
+        CHECK(!loader.load(ms.get_root_menu(), blob.data(), size));
+        CHECK_EQUAL(loader.get_error(), MenuBlobLoader::ERROR_TRUNCATED);
+        CHECK_EQUAL(loader.get_arena_used(), 0);
+        CHECK_EQUAL(ms.get_root_menu().get_num_components(), 1);
+    }
+
+    // So does every arena that's too small
+    CHECK(loader.load(ms.get_root_menu(), blob.data(), blob.size()));
+    size_t arena_needed = loader.get_arena_used();
+    alignas(8) uint8_t small_arena[1024];
+    for (size_t size = 0; size < arena_needed; ++size) {
+        MenuBlobLoader small_loader(ms, small_arena, size);
+        small_loader.set_select_functions(select_fns, 1);
+        CHECK(!small_loader.load(ms.get_root_menu(), blob.data(), blob.size()));
+        CHECK_EQUAL(small_loader.get_error(), MenuBlobLoader::ERROR_ARENA);
+        CHECK_EQUAL(small_loader.get_arena_used(), 0);
+        CHECK_EQUAL(ms.get_root_menu().get_num_components(), 3);
+    }
+
+    // More menus than the header announces
+    std::vector<uint8_t> bad_blob = blob;
+    bad_blob[6] = 1;
+    CHECK(!loader.load(ms.get_root_menu(), bad_blob.data(), bad_blob.size()));
+    CHECK_EQUAL(loader.get_error(), MenuBlobLoader::ERROR_FORMAT);
+    CHECK_EQUAL(loader.get_arena_used(), arena_needed);
+    CHECK_EQUAL(ms.get_root_menu().get_num_components(), 3);
+}
+
+}
+
+int main() {
+    test_load();
+    test_failed_loads();
+    return test_result("test_blob");
+}
@@ -0,0 +1,148 @@
+/*
+ * test_display.cpp - Tests that MenuSystem only renders when the menu
+ * changed, and the idle timeout.
+ *
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include "test.h"
+
+int test_failures = 0;
+
+namespace {
+
+int num_idle_calls = 0;
+
+void on_idle(MenuSystem& ms) {
+    ++num_idle_calls;
+}
+
+void advance_millis(uint32_t ms) {
+    host_nanos += ms * 1000000ULL;
+}
+
+void test_redundant_renders() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    MenuItem item1("item1", nullptr);
+    MenuItem item2("item2", nullptr);
+    ms.get_root_menu().add_item(&item1);
+    ms.get_root_menu().add_item(&item2);
+
+    ms.display();
+    CHECK_EQUAL(renderer.num_renders, 1);
+    ms.display();
+    CHECK_EQUAL(renderer.num_renders, 1);
+
+    // prev at the top changes nothing
+    CHECK(!ms.prev());
+    ms.display();
+    CHECK_EQUAL(renderer.num_renders, 1);
+
+    CHECK(ms.next());
+    ms.display();
+    ms.display();
+    CHECK_EQUAL(renderer.num_renders, 2);
+
+    // next at the bottom changes nothing either
+    CHECK(!ms.next());
+    ms.display();
+    CHECK_EQUAL(renderer.num_renders, 2);
+
+    ms.invalidate();
+    ms.display();
+    CHECK_EQUAL(renderer.num_renders, 3);
+}
+
+void test_idle_reset() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Menu submenu("submenu");
+    NumericMenuItem numeric("numeric", nullptr, 5, 0, 10);
+    MenuItem item("item", nullptr);
+    ms.get_root_menu().add_menu(&submenu);
+    submenu.add_item(&numeric);
+    submenu.add_item(&item);
+
+    ms.set_idle_timeout(1000);
+    ms.select();
+    ms.select();
+    ms.next();
+    ms.next();
+    CHECK(numeric.has_focus());
+    CHECK_EQUAL(numeric.get_value(), 7);
+    ms.display();
+    int num_renders = renderer.num_renders;
+
+    advance_millis(999);
+    ms.update();
+    CHECK(!ms.is_idle());
+    CHECK(ms.get_current_menu() == &submenu);
+
+    // The timeout resets to the root menu and cancels the open edit
+    advance_millis(1);
+    ms.update();
+    CHECK(ms.is_idle());
+    CHECK(ms.get_current_menu() == &ms.get_root_menu());
+    CHECK(!numeric.has_focus());
+    CHECK_EQUAL(numeric.get_value(), 5);
+    ms.display();
+    CHECK_EQUAL(renderer.num_renders, num_renders + 1);
+
+    // Staying idle neither resets nor renders again
+    advance_millis(5000);
+    ms.update();
+    ms.display();
+    CHECK_EQUAL(renderer.num_renders, num_renders + 1);
+
+    // Input wakes the menu up and renders it even if nothing moved
+    CHECK(!ms.prev());
+    CHECK(!ms.is_idle());
+    ms.display();
+    CHECK_EQUAL(renderer.num_renders, num_renders + 2);
+
+    ms.select();
+    CHECK(ms.next());
+    CHECK(submenu.get_current_component() == &item);
+    CHECK_EQUAL(numeric.get_value(), 5);
+}
+
+void test_idle_function() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Menu submenu("submenu");
+    MenuItem item("item", nullptr);
+    ms.get_root_menu().add_menu(&submenu);
+    submenu.add_item(&item);
+
+    num_idle_calls = 0;
+    ms.set_idle_timeout(500, on_idle);
+    ms.select();
+    advance_millis(500);
+    ms.update();
+    ms.update();
+    CHECK_EQUAL(num_idle_calls, 1);
+    CHECK(ms.is_idle());
+
+    // The idle function replaces the reset
+    CHECK(ms.get_current_menu() == &submenu);
+
+    ms.back();
+    CHECK(!ms.is_idle());
+    advance_millis(499);
+    ms.update();
+    CHECK_EQUAL(num_idle_calls, 1);
+    advance_millis(1);
+    ms.update();
+    CHECK_EQUAL(num_idle_calls, 2);
+}
+
+}
+
+int main() {
+    test_redundant_renders();
+    test_idle_reset();
+    test_idle_function();
+    return test_result("test_display");
+}
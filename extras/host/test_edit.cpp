@@ -0,0 +1,95 @@
+/*
+ * test_edit.cpp - Tests editing numeric and choice items as transactions.
+ *
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include "test.h"
+
+int test_failures = 0;
+
+namespace {
+
+const char LABEL_A[] PROGMEM = "a";
+const char LABEL_B[] PROGMEM = "b";
+const char LABEL_C[] PROGMEM = "c";
+const char* const LABELS[] PROGMEM = { LABEL_A, LABEL_B, LABEL_C };
+
+int num_commits = 0;
+
+void on_commit(MenuComponent* p_menu_component) {
+    ++num_commits;
+}
+
+void test_back_cancels() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    NumericMenuItem numeric("numeric", on_commit, 5, 0, 10);
+    ms.get_root_menu().add_item(&numeric);
+
+    num_commits = 0;
+    ms.select();
+    CHECK(numeric.has_focus());
+    ms.next();
+    ms.next();
+    CHECK_EQUAL(numeric.get_value(), 7);
+    CHECK(ms.back());
+    CHECK(!numeric.has_focus());
+    CHECK_EQUAL(numeric.get_value(), 5);
+    CHECK_EQUAL(num_commits, 0);
+
+    ms.select();
+    ms.next();
+    ms.select();
+    CHECK(!numeric.has_focus());
+    CHECK_EQUAL(numeric.get_value(), 6);
+    CHECK_EQUAL(num_commits, 1);
+}
+
+void test_reset_cancels() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Menu submenu("submenu");
+    NumericMenuItem numeric("numeric", on_commit, 5, 0, 10);
+    ChoiceMenuItem choice("choice", on_commit, LABELS, 3);
+    ms.get_root_menu().add_menu(&submenu);
+    submenu.add_item(&numeric);
+    submenu.add_item(&choice);
+
+    num_commits = 0;
+    ms.select();
+    ms.select();
+    ms.next();
+    ms.next();
+    CHECK(numeric.has_focus());
+    CHECK_EQUAL(numeric.get_value(), 7);
+
+    ms.reset();
+    CHECK(!numeric.has_focus());
+    CHECK_EQUAL(numeric.get_value(), 5);
+    CHECK(ms.get_current_menu() == &ms.get_root_menu());
+
+    // After entering the submenu again next moves the cursor
+    ms.select();
+    CHECK(ms.next());
+    CHECK(submenu.get_current_component() == &choice);
+    CHECK_EQUAL(numeric.get_value(), 5);
+
+    ms.select();
+    ms.next();
+    CHECK(choice.has_focus());
+    CHECK_EQUAL(choice.get_index(), 1);
+    ms.reset();
+    CHECK(!choice.has_focus());
+    CHECK_EQUAL(choice.get_index(), 0);
+    CHECK_EQUAL(num_commits, 0);
+}
+
+}
+
+int main() {
+    test_back_cancels();
+    test_reset_cancels();
+    return test_result("test_edit");
+}
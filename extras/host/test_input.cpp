@@ -0,0 +1,193 @@
+/*
+ * test_input.cpp - Tests the gestures recognised by MenuInput on synthetic
+ * timelines of button samples.
+ *
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include "test.h"
+#include <MenuInput.h>
+#include <vector>
+
+int test_failures = 0;
+
+namespace {
+
+const uint8_t NUM_ITEMS = 20;
+
+//! A root menu of a submenu followed by NUM_ITEMS items.
+struct Tree {
+    Tree(MenuSystem& ms)
+    : submenu("submenu"),
+      sub_item("sub_item", nullptr),
+      items(NUM_ITEMS, MenuItem("item", nullptr)) {
+        ms.get_root_menu().add_menu(&submenu);
+        submenu.add_item(&sub_item);
+        for (MenuItem& item : items)
+            ms.get_root_menu().add_item(&item);
+    }
+
+    Menu submenu;
+    MenuItem sub_item;
+    std::vector<MenuItem> items;
+};
+
+//! Samples button 0 every millisecond for duration milliseconds.
+void hold(MenuInput& input, bool pressed, uint32_t& now, uint32_t duration) {
+    for (uint32_t end = now + duration; now < end; ++now)
+        input.sample(0, pressed, now);
+}
+
+Menu::ComponentIndex cursor(MenuSystem& ms) {
+    return ms.get_current_menu()->get_current_component_num();
+}
+
+void test_debounce() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Tree tree(ms);
+    MenuInput input(ms);
+    input.set_button(0, MenuInput::ACTION_NEXT);
+    uint32_t now = 1000;
+
+    // A glitch shorter than the debounce time is ignored
+    hold(input, true, now, 10);
+    hold(input, false, now, 100);
+    CHECK_EQUAL(cursor(ms), 0);
+
+    // A bouncing press and release count once
+    hold(input, true, now, 3);
+    hold(input, false, now, 2);
+    hold(input, true, now, 5);
+    hold(input, false, now, 1);
+    hold(input, true, now, 100);
+    hold(input, false, now, 4);
+    hold(input, true, now, 2);
+    hold(input, false, now, 100);
+    CHECK_EQUAL(cursor(ms), 1);
+}
+
+void test_long_press() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Tree tree(ms);
+    MenuInput input(ms);
+    input.set_button(0, MenuInput::ACTION_SELECT, MenuInput::ACTION_BACK);
+    uint32_t now = 1000;
+
+    // A short press selects when released
+    hold(input, true, now, 100);
+    CHECK(ms.get_current_menu() == &ms.get_root_menu());
+    hold(input, false, now, 100);
+    CHECK(ms.get_current_menu() == &tree.submenu);
+
+    // A long press goes back once the long press time has passed, and the
+    // release doesn't select
+    hold(input, true, now, 700);
+    CHECK(ms.get_current_menu() == &tree.submenu);
+    hold(input, true, now, 500);
+    CHECK(ms.get_current_menu() == &ms.get_root_menu());
+    hold(input, false, now, 100);
+    CHECK(ms.get_current_menu() == &ms.get_root_menu());
+    CHECK_EQUAL(cursor(ms), 0);
+}
+
+void test_double_press() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Tree tree(ms);
+    MenuInput input(ms);
+    input.set_button(0, MenuInput::ACTION_NEXT, MenuInput::ACTION_NONE,
+                     MenuInput::ACTION_RESET);
+    uint32_t now = 1000;
+
+    // A single press acts once the double press window has passed
+    hold(input, true, now, 100);
+    hold(input, false, now, 200);
+    CHECK_EQUAL(cursor(ms), 0);
+    hold(input, false, now, 200);
+    CHECK_EQUAL(cursor(ms), 1);
+
+    hold(input, true, now, 100);
+    hold(input, false, now, 400);
+    CHECK_EQUAL(cursor(ms), 2);
+
+    // A second press within the window is a double press only
+    hold(input, true, now, 100);
+    hold(input, false, now, 100);
+    hold(input, true, now, 100);
+    hold(input, false, now, 500);
+    CHECK_EQUAL(cursor(ms), 0);
+}
+
+void test_repeat() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Tree tree(ms);
+    MenuInput input(ms);
+    input.set_button(0, MenuInput::ACTION_NEXT, MenuInput::ACTION_NONE,
+                     MenuInput::ACTION_NONE, true);
+    uint32_t now = 1000;
+
+    // The press at 20 ms, then repeats at 520, 620, 720, 820 and 920 ms
+    hold(input, true, now, 1000);
+    CHECK_EQUAL(cursor(ms), 6);
+    hold(input, false, now, 100);
+    CHECK_EQUAL(cursor(ms), 6);
+
+    // The repeat delay starts again with every press
+    hold(input, true, now, 500);
+    CHECK_EQUAL(cursor(ms), 7);
+    hold(input, false, now, 100);
+    CHECK_EQUAL(cursor(ms), 7);
+}
+
+void test_repeat_after_stall() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Tree tree(ms);
+    MenuInput input(ms);
+    input.set_button(0, MenuInput::ACTION_NEXT, MenuInput::ACTION_NONE,
+                     MenuInput::ACTION_NONE, true);
+
+    input.sample(0, true, 1000);
+    input.sample(0, true, 1020);
+    CHECK_EQUAL(cursor(ms), 1);
+
+    // A loop that stalled for two seconds repeats once, not 15 times
+    input.sample(0, true, 3020);
+    CHECK_EQUAL(cursor(ms), 2);
+    input.sample(0, true, 3060);
+    CHECK_EQUAL(cursor(ms), 2);
+    input.sample(0, true, 3120);
+    CHECK_EQUAL(cursor(ms), 3);
+}
+
+void test_repeat_with_double_press() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Tree tree(ms);
+    MenuInput input(ms);
+    input.set_button(0, MenuInput::ACTION_NEXT, MenuInput::ACTION_NONE,
+                     MenuInput::ACTION_RESET, true);
+    uint32_t now = 1000;
+
+    // Repeat is ignored: the press action only fires after the release
+    hold(input, true, now, 1000);
+    CHECK_EQUAL(cursor(ms), 0);
+    hold(input, false, now, 400);
+    CHECK_EQUAL(cursor(ms), 1);
+}
+
+}
+
+int main() {
+    test_debounce();
+    test_long_press();
+    test_double_press();
+    test_repeat();
+    test_repeat_after_stall();
+    test_repeat_with_double_press();
+    return test_result("test_input");
+}
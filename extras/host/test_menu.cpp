@@ -0,0 +1,167 @@
+/*
+ * test_menu.cpp - Tests menus with many components, and the cursor of menus
+ * with hidden components.
+ *
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include "test.h"
+#include <vector>
+
+int test_failures = 0;
+
+namespace {
+
+const Menu::ComponentIndex MAX_COMPONENTS =
+    (Menu::ComponentIndex) ~(Menu::ComponentIndex) 0;
+
+void test_10k_components() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Menu& menu = ms.get_root_menu();
+    std::vector<MenuItem> items(10000, MenuItem("item", nullptr));
+
+    for (MenuItem& item : items)
+        menu.add_item(&item);
+    CHECK_EQUAL(menu.get_num_components(), 10000);
+    CHECK_EQUAL(menu.get_num_visible_components(), 10000);
+    CHECK(menu.get_menu_component(9999) == &items[9999]);
+    CHECK_EQUAL(menu.get_current_component_num(), 0);
+
+    // Without looping the cursor stops at the ends
+    CHECK(!ms.prev(false));
+    CHECK_EQUAL(menu.get_current_component_num(), 0);
+
+    // Looping wraps both ways
+    CHECK(ms.prev(true));
+    CHECK_EQUAL(menu.get_current_component_num(), 9999);
+    CHECK(menu.get_current_component() == &items[9999]);
+    CHECK(!ms.next(false));
+    CHECK_EQUAL(menu.get_current_component_num(), 9999);
+    CHECK(ms.next(true));
+    CHECK_EQUAL(menu.get_current_component_num(), 0);
+
+    for (int i = 0; i < 5000; ++i)
+        ms.next();
+    CHECK_EQUAL(menu.get_current_component_num(), 5000);
+}
+
+void test_visible_iteration() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Menu& menu = ms.get_root_menu();
+    std::vector<MenuItem> items(10000, MenuItem("item", nullptr));
+
+    for (MenuItem& item : items)
+        menu.add_item(&item);
+    for (Menu::ComponentIndex i = 0; i < 10000; i += 3)
+        menu.set_component_visible(i, false);
+    menu.set_component_visible(9998, false);
+    menu.set_component_visible(9999, false);
+
+    // Visits the same components as get_visible_component, in order
+    Menu::ComponentIndex i;
+    Menu::ComponentIndex visible_index = 0;
+    for (bool found = menu.get_next_visible_component_num(0, i); found;
+            found = menu.get_next_visible_component_num(i + 1, i)) {
+        CHECK(menu.is_component_visible(i));
+        CHECK(menu.get_menu_component(i)
+              == menu.get_visible_component(visible_index));
+        visible_index++;
+    }
+    CHECK_EQUAL(visible_index, menu.get_num_visible_components());
+    CHECK_EQUAL(visible_index, 6665);
+
+    CHECK(menu.get_next_visible_component_num(0, i));
+    CHECK_EQUAL(i, 1);
+    CHECK(!menu.get_next_visible_component_num(9998, i));
+    CHECK(!menu.get_next_visible_component_num(10000, i));
+}
+
+void test_reserve() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Menu& menu = ms.get_root_menu();
+    MenuItem item("item", nullptr);
+
+    CHECK(menu.reserve(10000));
+    for (int i = 0; i < 10000; ++i)
+        menu.add_item(&item);
+    CHECK_EQUAL(menu.get_num_components(), 10000);
+}
+
+void test_max_components() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Menu& menu = ms.get_root_menu();
+    MenuItem item("item", nullptr);
+    MenuItem extra("extra", nullptr);
+
+    for (long i = 0; i < (long) MAX_COMPONENTS; ++i)
+        menu.add_item(&item);
+    CHECK_EQUAL(menu.get_num_components(), MAX_COMPONENTS);
+
+    // Adding past the maximum ComponentIndex is refused
+    menu.add_item(&extra);
+    CHECK_EQUAL(menu.get_num_components(), MAX_COMPONENTS);
+    CHECK(menu.get_menu_component(MAX_COMPONENTS - 1) == &item);
+
+    CHECK(ms.prev(true));
+    CHECK_EQUAL(menu.get_current_component_num(), MAX_COMPONENTS - 1);
+    CHECK(ms.next(true));
+    CHECK_EQUAL(menu.get_current_component_num(), 0);
+}
+
+int num_selects = 0;
+
+void on_select(MenuComponent* p_menu_component) {
+    ++num_selects;
+}
+
+void test_hidden_cursor() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Menu& menu = ms.get_root_menu();
+    MenuItem a("a", on_select);
+    MenuItem b("b", on_select);
+    MenuItem c("c", on_select);
+
+    // Hidden as soon as it's added, as MenuBlobLoader does: the next visible
+    // component added becomes current
+    menu.add_item(&a);
+    menu.set_component_visible(0, false);
+    CHECK_EQUAL(menu.get_current_component_num(), 0);
+    menu.add_item(&b);
+    CHECK_EQUAL(menu.get_current_component_num(), 1);
+    CHECK(menu.get_current_component() == &b);
+    num_selects = 0;
+    ms.select();
+    CHECK_EQUAL(num_selects, 1);
+
+    // Adding behind a visible current component leaves the cursor alone
+    menu.add_item(&c);
+    CHECK_EQUAL(menu.get_current_component_num(), 1);
+
+    // Showing a component when all of them are hidden makes it current
+    menu.set_component_visible(1, false);
+    menu.set_component_visible(2, false);
+    CHECK(!menu.is_component_visible(menu.get_current_component_num()));
+    menu.set_component_visible(2, true);
+    CHECK_EQUAL(menu.get_current_component_num(), 2);
+    menu.set_component_visible(0, true);
+    CHECK_EQUAL(menu.get_current_component_num(), 2);
+    ms.select();
+    CHECK_EQUAL(num_selects, 2);
+}
+
+}
+
+int main() {
+    test_10k_components();
+    test_visible_iteration();
+    test_reserve();
+    test_max_components();
+    test_hidden_cursor();
+    return test_result("test_menu");
+}
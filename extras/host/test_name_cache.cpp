@@ -0,0 +1,172 @@
+/*
+ * test_name_cache.cpp - Tests NameBitmapCache: least recently used eviction,
+ * rasterizing again after set_name, and blitting strips at every position
+ * against a pixel by pixel reference.
+ *
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include "test.h"
+#include <NameBitmapCache.h>
+#include <string.h>
+
+int test_failures = 0;
+
+namespace {
+
+int num_glyph_columns = 0;
+
+//! Distinct columns for every character, counting the calls.
+uint8_t glyph_column(char c, uint8_t column) {
+    ++num_glyph_columns;
+    return (uint8_t) (c * 7 + column * 31);
+}
+
+const NameBitmapCache::Font FONT = { glyph_column, 3, 1 };
+
+//! Checks the columns of strip, without counting them as rasterized.
+void check_strip(NameBitmapCache::Strip const& strip, const char* name) {
+    int saved_num_glyph_columns = num_glyph_columns;
+    uint16_t width = 0;
+    for (const char* p = name; *p != '\0'; ++p) {
+        if (p != name)
+            CHECK_EQUAL(strip.columns[width++], 0);
+        for (uint8_t i = 0; i < FONT.glyph_width; ++i)
+            CHECK_EQUAL(strip.columns[width++], glyph_column(*p, i));
+    }
+    CHECK_EQUAL(strip.width, width);
+    num_glyph_columns = saved_num_glyph_columns;
+}
+
+void test_lru() {
+    MenuItem a("ab", nullptr);
+    MenuItem b("cd", nullptr);
+    MenuItem c("ef", nullptr);
+    NameBitmapCache::Entry entries[2];
+    uint8_t columns[2 * 16];
+    NameBitmapCache cache(entries, 2, columns, 16);
+
+    num_glyph_columns = 0;
+    check_strip(cache.get(a, FONT), "ab");
+    CHECK_EQUAL(num_glyph_columns, 6);
+    num_glyph_columns = 0;
+    cache.get(a, FONT);
+    cache.get(b, FONT);
+    CHECK_EQUAL(num_glyph_columns, 6);
+
+    // a was used last, so c replaces b
+    num_glyph_columns = 0;
+    cache.get(a, FONT);
+    cache.get(c, FONT);
+    CHECK_EQUAL(num_glyph_columns, 6);
+    num_glyph_columns = 0;
+    check_strip(cache.get(a, FONT), "ab");
+    check_strip(cache.get(c, FONT), "ef");
+    CHECK_EQUAL(num_glyph_columns, 0);
+    num_glyph_columns = 0;
+    check_strip(cache.get(b, FONT), "cd");
+    CHECK_EQUAL(num_glyph_columns, 6);
+
+    // Names are clipped to the maximum width
+    MenuItem long_name("abcdefg", nullptr);
+    NameBitmapCache::Strip strip = cache.get(long_name, FONT);
+    CHECK_EQUAL(strip.width, 16);
+    CHECK_EQUAL(strip.columns[14], glyph_column('d', 2));
+    CHECK_EQUAL(strip.columns[15], 0);
+
+    cache.clear();
+    num_glyph_columns = 0;
+    cache.get(c, FONT);
+    CHECK_EQUAL(num_glyph_columns, 6);
+}
+
+void test_set_name() {
+    MenuItem item("ab", nullptr);
+    NameBitmapCache::Entry entries[1];
+    uint8_t columns[16];
+    NameBitmapCache cache(entries, 1, columns, 16);
+
+    check_strip(cache.get(item, FONT), "ab");
+    item.set_name("xyz");
+    check_strip(cache.get(item, FONT), "xyz");
+    num_glyph_columns = 0;
+    cache.get(item, FONT);
+    CHECK_EQUAL(num_glyph_columns, 0);
+
+    // The same buffer rewritten in place
+    char name[8] = "one";
+    item.set_name(name);
+    check_strip(cache.get(item, FONT), "one");
+    strcpy(name, "two");
+    item.set_name(name);
+    check_strip(cache.get(item, FONT), "two");
+}
+
+const uint16_t FRAME_WIDTH = 16;
+const uint8_t FRAME_PAGES = 3;
+
+bool get_pixel(uint8_t const* frame, int16_t x, int16_t y) {
+    return frame[(y >> 3) * FRAME_WIDTH + x] & (1 << (y & 7));
+}
+
+void set_pixel(uint8_t* frame, int16_t x, int16_t y, bool on) {
+    if (on)
+        frame[(y >> 3) * FRAME_WIDTH + x] |= 1 << (y & 7);
+    else
+        frame[(y >> 3) * FRAME_WIDTH + x] &= ~(1 << (y & 7));
+}
+
+void test_blit() {
+    MenuItem item("abc", nullptr);
+    NameBitmapCache::Entry entries[1];
+    uint8_t columns[16];
+    NameBitmapCache cache(entries, 1, columns, 16);
+    NameBitmapCache::Strip strip = cache.get(item, FONT);
+
+    // Page aligned, straddling two pages, and clipped on every side
+    for (int16_t y = -10; y <= FRAME_PAGES * 8 + 2; ++y) {
+        for (int16_t x = -14; x <= FRAME_WIDTH + 2; ++x) {
+            uint8_t frame[FRAME_WIDTH * FRAME_PAGES];
+            uint8_t expected[FRAME_WIDTH * FRAME_PAGES];
+            for (size_t i = 0; i < sizeof(frame); ++i)
+                frame[i] = (uint8_t) (i * 73 + 41);
+            memcpy(expected, frame, sizeof(frame));
+
+            for (int16_t column = 0; column < strip.width; ++column) {
+                for (int16_t row = 0; row < 8; ++row) {
+                    int16_t pixel_x = x + column;
+                    int16_t pixel_y = y + row;
+                    if (pixel_x >= 0 && pixel_x < FRAME_WIDTH && pixel_y >= 0
+                            && pixel_y < FRAME_PAGES * 8)
+                        set_pixel(expected, pixel_x, pixel_y,
+                                  strip.columns[column] & (1 << row));
+                }
+            }
+
+            NameBitmapCache::blit(strip, frame, FRAME_WIDTH, FRAME_PAGES, x,
+                                  y);
+            if (!CHECK(memcmp(frame, expected, sizeof(frame)) == 0)) {
+                fprintf(stderr, "  at x=%d y=%d\n", x, y);
+                return;
+            }
+        }
+    }
+
+    // Only the columns of the strip are touched
+    uint8_t frame[FRAME_WIDTH * FRAME_PAGES] = {};
+    NameBitmapCache::blit(strip, frame, FRAME_WIDTH, FRAME_PAGES, 2, 8);
+    CHECK_EQUAL(frame[FRAME_WIDTH + 1], 0);
+    CHECK_EQUAL(frame[FRAME_WIDTH + 2], strip.columns[0]);
+    CHECK_EQUAL(frame[FRAME_WIDTH + 2 + strip.width], 0);
+    CHECK(get_pixel(frame, 2, 8) == (bool) (strip.columns[0] & 1));
+}
+
+}
+
+int main() {
+    test_lru();
+    test_set_name();
+    test_blit();
+    return test_result("test_name_cache");
+}
@@ -0,0 +1,128 @@
+/*
+ * test_navigation.cpp - Tests MenuSystem's navigation stack: menus shared by
+ * several parents, breadcrumbs and the maximum depth.
+ *
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include "test.h"
+#include <vector>
+
+int test_failures = 0;
+
+namespace {
+
+int num_selects = 0;
+
+void on_select(MenuComponent* p_menu_component) {
+    ++num_selects;
+}
+
+void test_shared_menu() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Menu a("a");
+    Menu b("b");
+    Menu shared("shared");
+    MenuItem x("x", nullptr);
+    MenuItem y("y", nullptr);
+    MenuItem s1("s1", nullptr);
+    MenuItem s2("s2", nullptr);
+    Menu& root = ms.get_root_menu();
+    root.add_menu(&a);
+    root.add_menu(&b);
+    a.add_item(&x);
+    a.add_menu(&shared);
+    b.add_menu(&shared);
+    b.add_item(&y);
+    shared.add_item(&s1);
+    shared.add_item(&s2);
+
+    // Through a
+    ms.select();
+    ms.next();
+    ms.select();
+    CHECK(ms.get_current_menu() == &shared);
+    CHECK_EQUAL(ms.get_depth(), 2);
+    CHECK(ms.get_menu(0) == &root);
+    CHECK(ms.get_menu(1) == &a);
+    CHECK(ms.get_menu(2) == &shared);
+    CHECK_EQUAL(ms.get_entry_component_num(0), 0);
+    CHECK_EQUAL(ms.get_entry_component_num(1), 1);
+
+    // back restores the cursor the parent was entered from, even if it
+    // moved meanwhile
+    a.set_component_visible(1, false);
+    a.set_component_visible(1, true);
+    CHECK_EQUAL(a.get_current_component_num(), 0);
+    CHECK(ms.back());
+    CHECK(ms.get_current_menu() == &a);
+    CHECK_EQUAL(a.get_current_component_num(), 1);
+    CHECK(ms.back());
+    CHECK(ms.get_current_menu() == &root);
+    CHECK_EQUAL(ms.get_depth(), 0);
+    CHECK(!ms.back());
+
+    // Through b, back returns to b rather than a
+    ms.next();
+    ms.select();
+    ms.select();
+    CHECK(ms.get_current_menu() == &shared);
+    CHECK(ms.get_menu(1) == &b);
+    CHECK_EQUAL(ms.get_entry_component_num(0), 1);
+    CHECK_EQUAL(ms.get_entry_component_num(1), 0);
+    CHECK(ms.back());
+    CHECK(ms.get_current_menu() == &b);
+    CHECK_EQUAL(b.get_current_component_num(), 0);
+    CHECK(ms.back());
+    CHECK(ms.get_current_menu() == &root);
+    CHECK_EQUAL(root.get_current_component_num(), 1);
+
+    ms.select();
+    ms.select();
+    ms.reset();
+    CHECK(ms.get_current_menu() == &root);
+    CHECK_EQUAL(ms.get_depth(), 0);
+}
+
+void test_max_depth() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    std::vector<Menu> menus(MENUSYSTEM_MAX_DEPTH + 1,
+                            Menu("menu", on_select));
+    Menu* p_parent = &ms.get_root_menu();
+    for (Menu& menu : menus) {
+        p_parent->add_menu(&menu);
+        p_parent = &menu;
+    }
+    MenuItem leaf("leaf", on_select);
+    p_parent->add_item(&leaf);
+
+    num_selects = 0;
+    for (uint8_t i = 0; i < MENUSYSTEM_MAX_DEPTH; ++i)
+        ms.select();
+    CHECK_EQUAL(ms.get_depth(), MENUSYSTEM_MAX_DEPTH);
+    CHECK(ms.get_current_menu() == &menus[MENUSYSTEM_MAX_DEPTH - 1]);
+    CHECK_EQUAL(num_selects, MENUSYSTEM_MAX_DEPTH);
+
+    // The next menu is too deep: nothing happens, not even its select
+    // function
+    ms.select();
+    CHECK_EQUAL(ms.get_depth(), MENUSYSTEM_MAX_DEPTH);
+    CHECK(ms.get_current_menu() == &menus[MENUSYSTEM_MAX_DEPTH - 1]);
+    CHECK_EQUAL(num_selects, MENUSYSTEM_MAX_DEPTH);
+
+    for (uint8_t i = 0; i < MENUSYSTEM_MAX_DEPTH; ++i)
+        CHECK(ms.back());
+    CHECK(ms.get_current_menu() == &ms.get_root_menu());
+    CHECK(!ms.back());
+}
+
+}
+
+int main() {
+    test_shared_menu();
+    test_max_depth();
+    return test_result("test_navigation");
+}
@@ -0,0 +1,396 @@
+/*
+ * test_stream.cpp - Tests that a MenuStreamMirror fed by a MenuStreamWriter
+ * matches the MenuSystem after every key and every change of the component
+ * flags, including a resync after a lost frame.
+ *
+ * Copyright (c) 2026 arduino-menusystem
+ * Licensed under the MIT license (see LICENSE)
+ */
+
+#include "test.h"
+#include <MenuStream.h>
+#include <string.h>
+
+int test_failures = 0;
+
+namespace {
+
+const char LABEL_OFF[] PROGMEM = "off";
+const char LABEL_ON[] PROGMEM = "on";
+const char LABEL_AUTO[] PROGMEM = "auto";
+const char* const LABELS[] PROGMEM = { LABEL_OFF, LABEL_ON, LABEL_AUTO };
+
+//! Collects the frames written by a MenuStreamWriter until they are
+//! delivered to a mirror.
+class Link : public Print {
+public:
+    Link() : length(0) {}
+
+    size_t write(uint8_t value) {
+        if (length == sizeof(buffer))
+            return 0;
+        buffer[length++] = value;
+        return 1;
+    }
+
+    //! Feeds the collected bytes to mirror, losing the first frame if
+    //! drop_first_frame is true.
+    void deliver(MenuStreamMirror& mirror, bool drop_first_frame=false) {
+        size_t i = 0;
+        if (drop_first_frame && length >= 4)
+            i = 5 + buffer[3];
+        for (; i < length; ++i)
+            mirror.read(buffer[i]);
+        length = 0;
+    }
+
+    //! Returns the number of collected frames of type.
+    int count(MenuStream::MessageType type) const {
+        int num_frames = 0;
+        for (size_t i = 0; i + 4 <= length; i += 5 + buffer[i + 3]) {
+            if (buffer[i + 1] == type)
+                num_frames++;
+        }
+        return num_frames;
+    }
+
+    uint8_t buffer[4096];
+    size_t length;
+};
+
+struct Tree {
+    Tree(MenuSystem& ms)
+    : item("item", nullptr),
+      settings("settings"),
+      contrast("contrast", nullptr, 5, 0, 10),
+      mode("mode", nullptr, LABELS, 3),
+      back("back", nullptr, &ms),
+      tools("tools"),
+      about("about", nullptr),
+      shared("shared"),
+      deep("deep", nullptr) {
+        ms.get_root_menu().add_item(&item);
+        ms.get_root_menu().add_menu(&settings);
+        ms.get_root_menu().add_menu(&tools);
+        settings.add_item(&contrast);
+        settings.add_item(&mode);
+        settings.add_menu(&shared);
+        settings.add_item(&back);
+        tools.add_menu(&shared);
+        tools.add_item(&about);
+        shared.add_item(&deep);
+    }
+
+    MenuItem item;
+    Menu settings;
+    NumericMenuItem contrast;
+    ChoiceMenuItem mode;
+    BackMenuItem back;
+    Menu tools;
+    MenuItem about;
+    Menu shared;
+    MenuItem deep;
+};
+
+void check_tree(MenuStreamMirror const& mirror, uint16_t node,
+                MenuComponent const& component, uint8_t flags=0) {
+    if (!CHECK(node != MenuStreamMirror::NO_NODE))
+        return;
+
+    MenuStreamMirror::Node const& mirrored = mirror.get_node(node);
+    CHECK_EQUAL(mirrored.type, component.get_type());
+    CHECK(strcmp(mirror.get_name(node), component.get_name()) == 0);
+    CHECK_EQUAL(mirrored.flags, flags);
+
+    if (component.get_type() == MenuComponent::TYPE_MENU) {
+        Menu const& menu = static_cast<Menu const&>(component);
+        CHECK_EQUAL(mirrored.num_children, menu.get_num_components());
+        for (Menu::ComponentIndex i = 0; i < menu.get_num_components(); ++i) {
+            uint8_t child_flags = 0;
+            if (!menu.is_component_visible(i))
+                child_flags |= MenuStream::FLAG_HIDDEN;
+            if (!menu.is_component_enabled(i))
+                child_flags |= MenuStream::FLAG_DISABLED;
+            check_tree(mirror, mirror.get_child(node, i),
+                       *menu.get_menu_component(i), child_flags);
+        }
+    } else if (component.get_type() == MenuComponent::TYPE_NUMERIC_MENU_ITEM) {
+        NumericMenuItem const& item =
+            static_cast<NumericMenuItem const&>(component);
+        CHECK(mirrored.value == item.get_value());
+        CHECK(mirrored.min_value == item.get_min_value());
+        CHECK(mirrored.max_value == item.get_max_value());
+        CHECK(mirrored.increment == item.get_increment());
+    } else if (component.get_type() == MenuComponent::TYPE_CHOICE_MENU_ITEM) {
+        ChoiceMenuItem const& item =
+            static_cast<ChoiceMenuItem const&>(component);
+        CHECK_EQUAL(mirrored.choice, item.get_index());
+        CHECK_EQUAL(mirrored.num_choices, item.get_num_choices());
+        for (uint8_t i = 0; i < item.get_num_choices(); ++i)
+            CHECK(strcmp(mirror.get_label(node, i),
+                         (const char*) item.get_label(i)) == 0);
+    }
+}
+
+//! Checks the state and the current menu. The flags of the menus below the
+//! current menu are only sent when they become current.
+void check_state(MenuStreamMirror const& mirror, MenuSystem const& ms) {
+    CHECK(mirror.is_valid());
+    CHECK_EQUAL(mirror.get_depth(), ms.get_depth());
+    CHECK_EQUAL(mirror.get_current_component_num(),
+                ms.get_current_menu()->get_current_component_num());
+    CHECK_EQUAL(mirror.has_focus(),
+                ms.get_current_menu()->get_current_component()->has_focus());
+
+    // The mirror must be in the occurrence of the menu it was entered through
+    uint16_t menu = 0;
+    for (uint8_t i = 0; i < ms.get_depth(); ++i)
+        menu = mirror.get_child(menu, ms.get_entry_component_num(i));
+    CHECK_EQUAL(mirror.get_current_menu(), menu);
+
+    Menu const* p_menu = ms.get_current_menu();
+    check_tree(mirror, menu, *p_menu, mirror.get_node(menu).flags);
+}
+
+void press(MenuSystem& ms, char key) {
+    switch (key) {
+        case 'n': ms.next(); break;
+        case 'p': ms.prev(); break;
+        case 's': ms.select(); break;
+        case 'b': ms.back(); break;
+        case 'r': ms.reset(); break;
+    }
+}
+
+void test_loopback() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Tree tree(ms);
+    MenuStreamMirror::Node nodes[12];
+    char text[128];
+    MenuStreamMirror mirror(nodes, 12, text, sizeof(text));
+    Link link;
+    MenuStreamWriter writer(ms, link);
+
+    CHECK(!mirror.is_valid());
+    writer.send_snapshot();
+    link.deliver(mirror);
+    CHECK(!mirror.needs_resync());
+    CHECK_EQUAL(mirror.get_num_nodes(), 12);
+    check_tree(mirror, 0, ms.get_root_menu());
+    check_state(mirror, ms);
+
+    // Edit and cancel, edit and commit, pick a choice, enter the shared menu
+    // from both of its parents, then reset
+    const char* keys = "pnssnnbsnsnsnsnsbbnssbbnssr";
+    for (const char* p_key = keys; *p_key; ++p_key) {
+        press(ms, *p_key);
+        writer.update();
+        link.deliver(mirror);
+        check_state(mirror, ms);
+    }
+    CHECK_EQUAL(tree.contrast.get_value(), 6);
+    CHECK_EQUAL(tree.mode.get_index(), 1);
+    check_tree(mirror, 0, ms.get_root_menu());
+}
+
+void test_resync() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Tree tree(ms);
+    MenuStreamMirror::Node nodes[12];
+    char text[128];
+    MenuStreamMirror mirror(nodes, 12, text, sizeof(text));
+    Link link;
+    MenuStreamWriter writer(ms, link);
+
+    writer.send_snapshot();
+    link.deliver(mirror);
+    check_state(mirror, ms);
+
+    // The lost cursor frame is noticed with the next frame
+    ms.next();
+    writer.update();
+    link.deliver(mirror, true);
+    ms.next();
+    writer.update();
+    link.deliver(mirror);
+    CHECK(mirror.needs_resync());
+    CHECK(!mirror.is_valid());
+
+    writer.send_snapshot();
+    link.deliver(mirror);
+    CHECK(!mirror.needs_resync());
+    check_state(mirror, ms);
+
+    ms.select();
+    writer.update();
+    link.deliver(mirror);
+    check_state(mirror, ms);
+}
+
+void test_flags() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Tree tree(ms);
+    MenuStreamMirror::Node nodes[12];
+    char text[128];
+    MenuStreamMirror mirror(nodes, 12, text, sizeof(text));
+    Link link;
+    MenuStreamWriter writer(ms, link);
+    Menu& root = ms.get_root_menu();
+
+    tree.settings.set_component_enabled(1, false);
+    writer.send_snapshot();
+    link.deliver(mirror);
+    check_tree(mirror, 0, root);
+    uint16_t mode = mirror.get_child(mirror.get_child(0, 1), 1);
+    CHECK_EQUAL(mirror.get_node(mode).flags, MenuStream::FLAG_DISABLED);
+
+    // Hiding the current component also moves the cursor
+    root.set_component_visible(0, false);
+    writer.update();
+    link.deliver(mirror);
+    CHECK_EQUAL(mirror.get_current_component_num(), 1);
+    check_state(mirror, ms);
+
+    root.set_component_enabled(2, false);
+    writer.update();
+    link.deliver(mirror);
+    check_state(mirror, ms);
+
+    // Flags changed in another menu arrive when it becomes current
+    tree.settings.set_component_visible(2, false);
+    tree.settings.set_component_enabled(1, true);
+    writer.update();
+    link.deliver(mirror);
+    ms.select();
+    writer.update();
+    link.deliver(mirror);
+    CHECK(ms.get_current_menu() == &tree.settings);
+    check_state(mirror, ms);
+
+    ms.back();
+    writer.update();
+    link.deliver(mirror);
+    check_tree(mirror, 0, root);
+}
+
+//! Delivers the frames of pressing keys one at a time and returns how many
+//! were MSG_FLAGS.
+int count_flags(MenuSystem& ms, MenuStreamWriter& writer, Link& link,
+                MenuStreamMirror& mirror, const char* keys) {
+    int num_frames = 0;
+    for (const char* p_key = keys; *p_key; ++p_key) {
+        press(ms, *p_key);
+        writer.update();
+        num_frames += link.count(MenuStream::MSG_FLAGS);
+        link.deliver(mirror);
+    }
+    return num_frames;
+}
+
+void test_flags_resent_when_changed() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Tree tree(ms);
+    MenuStreamMirror::Node nodes[12];
+    char text[128];
+    MenuStreamMirror mirror(nodes, 12, text, sizeof(text));
+    Link link;
+    MenuStreamWriter writer(ms, link);
+    Menu& root = ms.get_root_menu();
+
+    tree.tools.set_component_enabled(1, false);
+    writer.send_snapshot();
+    CHECK_EQUAL(link.count(MenuStream::MSG_FLAGS), 1);
+    link.deliver(mirror);
+
+    // The snapshot holds every flag, so switching menus sends none
+    CHECK_EQUAL(count_flags(ms, writer, link, mirror, "nsbnsbb"), 0);
+    check_tree(mirror, 0, root);
+
+    // A change in the current menu is sent right away, one in another menu
+    // when it becomes current, and both again whenever they become current
+    root.set_component_enabled(0, false);
+    tree.settings.set_component_visible(1, false);
+    CHECK_EQUAL(count_flags(ms, writer, link, mirror, "p"), 1);
+    CHECK_EQUAL(count_flags(ms, writer, link, mirror, "s"), 1);
+    CHECK_EQUAL(count_flags(ms, writer, link, mirror, "b"), 1);
+
+    // The shared menu changes while current under tools, so entering it
+    // under settings sends its flags again
+    CHECK_EQUAL(count_flags(ms, writer, link, mirror, "nss"), 0);
+    tree.shared.set_component_enabled(0, false);
+    CHECK_EQUAL(count_flags(ms, writer, link, mirror, "p"), 1);
+    CHECK_EQUAL(count_flags(ms, writer, link, mirror, "bbpsns"), 3);
+    check_state(mirror, ms);
+    check_tree(mirror, 0, root);
+
+    // A new snapshot starts over
+    writer.send_snapshot();
+    link.deliver(mirror);
+    CHECK_EQUAL(count_flags(ms, writer, link, mirror, "bbnsbns"), 0);
+    check_tree(mirror, 0, root);
+}
+
+void test_shared_menu_path() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Tree tree(ms);
+    MenuStreamMirror::Node nodes[12];
+    char text[128];
+    MenuStreamMirror mirror(nodes, 12, text, sizeof(text));
+    Link link;
+    MenuStreamWriter writer(ms, link);
+
+    writer.send_snapshot();
+    link.deliver(mirror);
+
+    const char* keys = "nsnns";
+    for (const char* p_key = keys; *p_key; ++p_key)
+        press(ms, *p_key);
+    writer.update();
+    link.deliver(mirror);
+    CHECK(ms.get_current_menu() == &tree.shared);
+    check_state(mirror, ms);
+
+    // Enter the shared menu through its other parent, at the same depth,
+    // between two updates
+    keys = "bbnss";
+    for (const char* p_key = keys; *p_key; ++p_key)
+        press(ms, *p_key);
+    writer.update();
+    link.deliver(mirror);
+    CHECK(ms.get_current_menu() == &tree.shared);
+    CHECK_EQUAL(ms.get_entry_component_num(0), 2);
+    check_state(mirror, ms);
+}
+
+void test_storage_too_small() {
+    CountingRenderer renderer;
+    MenuSystem ms(renderer);
+    Tree tree(ms);
+    MenuStreamMirror::Node nodes[4];
+    char text[128];
+    MenuStreamMirror mirror(nodes, 4, text, sizeof(text));
+    Link link;
+    MenuStreamWriter writer(ms, link);
+
+    writer.send_snapshot();
+    link.deliver(mirror);
+    CHECK(!mirror.needs_resync());
+    CHECK(!mirror.is_valid());
+}
+
+}
+
+int main() {
+    test_loopback();
+    test_resync();
+    test_flags();
+    test_flags_resent_when_changed();
+    test_shared_menu_path();
+    test_storage_too_small();
+    return test_result("test_stream");
+}
@@ -0,0 +1,239 @@
+#!/usr/bin/env python3
+#
+# menublob.py - Compiles a text description of a menu tree into the binary
+# format loaded by MenuBlobLoader (see MenuBlob.h).
+#
+# Every line describes a component; a menu's components follow it, indented
+# deeper. Blank lines and lines starting with # are ignored:
+#
+#     menu "Settings"
+#         numeric "Contrast" value=50 min=0 max=100 increment=5 select=on_contrast
+#         item "Factory reset" select=on_reset disabled
+#         back "Back"
+#     item "About" select=on_about
+#
+# Components are `menu`, `item`, `back` and `numeric`. The options are
+# `select=<function>`, `hidden`, `disabled` and, for numeric items, `value`,
+# `min`, `max` and `increment`. Select functions are numbered in order of
+# first use; --header writes the matching table initializer:
+#
+#     extras/menublob.py menu.txt -o menu.bin --header menu_fns.h
+#
+#     #include "menu_fns.h"
+#     MenuComponent::SelectFnPtr select_fns[] = MENUBLOB_SELECT_FNS;
+#
+# --generate prints a synthetic description with the given number of
+# components, e.g. for load time benchmarks.
+#
+# Copyright (c) 2026 arduino-menusystem
+# Licensed under the MIT license (see LICENSE)
+
+import argparse
+import shlex
+import struct
+import sys
+
+MAGIC = 0x424D
+VERSION = 1
+NO_SELECT_FN = 0xFF
+
+NODE_ITEM = 0
+NODE_BACK_ITEM = 1
+NODE_NUMERIC_ITEM = 2
+NODE_MENU = 4
+
+FLAG_HIDDEN = 0x01
+FLAG_DISABLED = 0x02
+
+NODE_TYPES = {
+    'item': NODE_ITEM,
+    'back': NODE_BACK_ITEM,
+    'numeric': NODE_NUMERIC_ITEM,
+    'menu': NODE_MENU,
+}
+
+NUMERIC_DEFAULTS = (('value', 0.0), ('min', 0.0), ('max', 100.0),
+                    ('increment', 1.0))
+
+
+class CompileError(Exception):
+    pass
+
+
+class Node:
+    def __init__(self, node_type, name, line_num):
+        self.type = node_type
+        self.name = name
+        self.line_num = line_num
+        self.flags = 0
+        self.select_fn = None
+        self.values = dict(NUMERIC_DEFAULTS)
+        self.children = []
+
+
+def parse_line(line, line_num):
+    try:
+        tokens = shlex.split(line)
+    except ValueError as e:
+        raise CompileError('line %d: %s' % (line_num, e))
+    if len(tokens) < 2 or tokens[0] not in NODE_TYPES:
+        raise CompileError('line %d: expected a component type and a name'
+                           % line_num)
+
+    node = Node(NODE_TYPES[tokens[0]], tokens[1], line_num)
+    for option in tokens[2:]:
+        key, _, value = option.partition('=')
+        if key == 'hidden' and not value:
+            node.flags |= FLAG_HIDDEN
+        elif key == 'disabled' and not value:
+            node.flags |= FLAG_DISABLED
+        elif key == 'select' and value:
+            node.select_fn = value
+        elif (key in node.values and value
+                and node.type == NODE_NUMERIC_ITEM):
+            try:
+                node.values[key] = float(value)
+            except ValueError:
+                raise CompileError('line %d: %s is not a number'
+                                   % (line_num, value))
+        else:
+            raise CompileError('line %d: unknown option %s'
+                               % (line_num, option))
+    return node
+
+
+def parse(lines):
+    root = Node(NODE_MENU, '', 0)
+    # (indent, node) of the menus enclosing the current line
+    stack = [(-1, root)]
+    for line_num, line in enumerate(lines, 1):
+        stripped = line.strip()
+        if not stripped or stripped.startswith('#'):
+            continue
+
+        indent = len(line) - len(line.lstrip())
+        while indent <= stack[-1][0]:
+            stack.pop()
+        parent = stack[-1][1]
+        if parent.type != NODE_MENU:
+            raise CompileError('line %d: only menus have components'
+                               % line_num)
+
+        node = parse_line(stripped, line_num)
+        parent.children.append(node)
+        stack.append((indent, node))
+    return root
+
+
+def walk(node):
+    for child in node.children:
+        yield child
+        for descendant in walk(child):
+            yield descendant
+
+
+def compile_tree(root):
+    select_fns = []
+    counts = dict.fromkeys(NODE_TYPES.values(), 0)
+    name_bytes = 0
+    body = bytearray()
+
+    for node in walk(root):
+        if node.type == NODE_MENU and len(node.children) > 0xFFFF:
+            raise CompileError('line %d: a menu has at most 65535 components'
+                               % node.line_num)
+        if node.select_fn is None:
+            select_fn_id = NO_SELECT_FN
+        else:
+            if node.select_fn not in select_fns:
+                select_fns.append(node.select_fn)
+            select_fn_id = select_fns.index(node.select_fn)
+            if select_fn_id >= NO_SELECT_FN:
+                raise CompileError('line %d: too many select functions'
+                                   % node.line_num)
+
+        name = node.name.encode('utf-8') + b'\0'
+        counts[node.type] += 1
+        name_bytes += len(name)
+
+        body += struct.pack('<BBB', node.type, node.flags, select_fn_id)
+        if node.type == NODE_MENU:
+            body += struct.pack('<H', len(node.children))
+        elif node.type == NODE_NUMERIC_ITEM:
+            body += struct.pack('<ffff', *(node.values[key]
+                                           for key, _ in NUMERIC_DEFAULTS))
+        body += name
+
+    if len(root.children) > 0xFFFF or max(counts.values()) > 0xFFFF:
+        raise CompileError('more than 65535 components of a kind')
+
+    header = struct.pack('<HBBHHHHHI', MAGIC, VERSION, 0, len(root.children),
+                         counts[NODE_MENU], counts[NODE_ITEM],
+                         counts[NODE_BACK_ITEM], counts[NODE_NUMERIC_ITEM],
+                         name_bytes)
+    return bytes(header + body), select_fns
+
+
+def generate(num_nodes, out):
+    """Writes a tree of menus holding ten menus or items each."""
+    out.write('# %d components generated by menublob.py\n' % num_nodes)
+    # Breadth-first numbering so the tree is as shallow as possible
+    children = [[] for _ in range(num_nodes + 1)]
+    for n in range(1, num_nodes + 1):
+        children[(n - 1) // 10].append(n)
+
+    def write(n, depth):
+        indent = '    ' * depth
+        if children[n]:
+            out.write('%smenu "Menu %d"\n' % (indent, n))
+            for child in children[n]:
+                write(child, depth + 1)
+        elif n % 10 == 1:
+            out.write('%snumeric "Value %d" value=%d select=on_value\n'
+                      % (indent, n, n % 100))
+        else:
+            out.write('%sitem "Item %d" select=on_item\n' % (indent, n))
+
+    for child in children[0]:
+        write(child, 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Compiles a menu description into a MenuBlob.')
+    parser.add_argument('input', nargs='?', help='the menu description')
+    parser.add_argument('-o', '--output', help='the blob to write')
+    parser.add_argument('--header',
+                        help='the select function table header to write')
+    parser.add_argument('--generate', type=int, metavar='NODES',
+                        help='print a synthetic description and exit')
+    args = parser.parse_args()
+
+    if args.generate is not None:
+        generate(args.generate, sys.stdout)
+        return 0
+    if args.input is None or args.output is None:
+        parser.error('input and --output are required')
+
+    try:
+        with open(args.input) as f:
+            blob, select_fns = compile_tree(parse(f))
+    except CompileError as e:
+        sys.stderr.write('%s: %s\n' % (args.input, e))
+        return 1
+
+    with open(args.output, 'wb') as f:
+        f.write(blob)
+    if args.header:
+        with open(args.header, 'w') as f:
+            f.write('// Generated by menublob.py from %s\n' % args.input)
+            f.write('#define MENUBLOB_SELECT_FNS { %s }\n'
+                    % ', '.join(select_fns))
+
+    print('%s: %d bytes, select functions: %s'
+          % (args.output, len(blob), ', '.join(select_fns) or 'none'))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,45 @@
+#!/bin/sh
+#
+# size_report.sh - Reports the flash and RAM used by MenuSystem.cpp for each
+# compile time feature configuration (see MENUSYSTEM_NUMERIC and friends in
+# MenuSystem.h).
+#
+# Run it from the library root. The toolchain and Arduino core default to
+# those used by the examples' Makefiles and can be overridden:
+#
+#     ARDUINO_DIR=~/arduino MCU=atmega2560 extras/size_report.sh
+#
+# Copyright (c) 2026 arduino-menusystem
+# Licensed under the MIT license (see LICENSE)
+
+ARDUINO_DIR=${ARDUINO_DIR:-$HOME/.arduino_ide}
+MCU=${MCU:-atmega328p}
+CXX=${CXX:-avr-g++}
+SIZE=${SIZE:-avr-size}
+TARGET_FLAGS=${TARGET_FLAGS--mmcu=$MCU -DF_CPU=16000000L}
+INCLUDES=${INCLUDES--I$ARDUINO_DIR/hardware/arduino/avr/cores/arduino -I$ARDUINO_DIR/hardware/arduino/avr/variants/standard}
+CXXFLAGS="-std=gnu++11 -Os -DARDUINO=10805 $TARGET_FLAGS $INCLUDES -I."
+
+OBJ=$(mktemp)
+trap 'rm -f "$OBJ"' EXIT
+
+report() {
+    name=$1
+    shift
+    if ! $CXX $CXXFLAGS "$@" -c MenuSystem.cpp -o "$OBJ"; then
+        echo "$name: compilation failed" >&2
+        exit 1
+    fi
+    $SIZE "$OBJ" | awk -v name="$name" 'NR == 2 {
+        printf "%-20s %8d %8d %8d\n", name, $1, $2, $3
+    }'
+}
+
+printf "%-20s %8s %8s %8s\n" "configuration" "text" "data" "bss"
+report "full"
+report "no numeric" -DMENUSYSTEM_NUMERIC=0
+report "no back item" -DMENUSYSTEM_BACK_ITEM=0
+report "no loop" -DMENUSYSTEM_LOOP=0
+report "no instrumentation" -DMENUSYSTEM_INSTRUMENTATION=0
+report "minimal" -DMENUSYSTEM_NUMERIC=0 -DMENUSYSTEM_BACK_ITEM=0 \
+                 -DMENUSYSTEM_LOOP=0 -DMENUSYSTEM_INSTRUMENTATION=0